@@ -0,0 +1,226 @@
+/**
+ * @file baseline.hpp
+ * @brief Comparison of benchmark results against a stored baseline
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ *
+ * This utility reads the JSON written by the bench executable and decides,
+ * for each benchmark, whether a new run is significantly slower than the
+ * baseline. A slowdown is only reported as a regression when it exceeds a
+ * tolerance even after accounting for the noise of both runs, estimated
+ * from the 95% confidence intervals of their repetitions.
+ */
+#pragma once
+#include "statistics.hpp"
+
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * @struct BaselineEntry
+ * @brief Stored statistics of one (kernel, size, threads) case
+ */
+struct BaselineEntry {
+    std::string name;    ///< Kernel name
+    size_t size;         ///< Subdivisions per direction
+    size_t threads;      ///< Number of threads
+    double mean;         ///< Mean timing (ns)
+    double ci95;         ///< Half-width of the 95% confidence interval of the mean (ns)
+    double median;       ///< Median timing (ns)
+};
+
+/**
+ * @class BaselineReader
+ * @brief Minimal reader for the JSON files written by bench
+ *
+ * Supports the subset of JSON produced by bench (objects, arrays, strings
+ * without escapes, numbers); unknown keys are ignored.
+ */
+class BaselineReader {
+public:
+    /**
+     * @brief Loads the benchmarks of a results file
+     * @param filename Path of the JSON file
+     * @throw std::runtime_error if the file cannot be read or parsed
+     */
+    static std::vector<BaselineEntry> load(const std::string& filename) {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            throw std::runtime_error("Impossible to open the file " + filename);
+        }
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        BaselineReader reader(buffer.str());
+        return reader.parse_document();
+    }
+
+private:
+    using Object = std::map<std::string, std::string>;  ///< Flat object: key -> raw scalar
+
+    explicit BaselineReader(const std::string& text) : m_text(text), m_pos(0) {}
+
+    std::vector<BaselineEntry> parse_document() {
+        std::vector<BaselineEntry> entries;
+        expect('{');
+        while (!consume('}')) {
+            const std::string key = parse_string();
+            expect(':');
+            if (key == "benchmarks") {
+                expect('[');
+                while (!consume(']')) {
+                    const Object object = parse_flat_object();
+                    entries.push_back(BaselineEntry{
+                        field(object, "name"),
+                        static_cast<size_t>(std::stoul(field(object, "size"))),
+                        static_cast<size_t>(std::stoul(field(object, "threads"))),
+                        std::stod(field(object, "mean_ns")),
+                        std::stod(field(object, "ci95_ns")),
+                        std::stod(field(object, "median_ns"))
+                    });
+                    consume(',');
+                }
+            } else {
+                skip_value();
+            }
+            consume(',');
+        }
+        return entries;
+    }
+
+    Object parse_flat_object() {
+        Object object;
+        expect('{');
+        while (!consume('}')) {
+            const std::string key = parse_string();
+            expect(':');
+            skip_whitespace();
+            object[key] = peek() == '"' ? parse_string() : parse_scalar();
+            consume(',');
+        }
+        return object;
+    }
+
+    void skip_value() {
+        skip_whitespace();
+        const char c = peek();
+        if (c == '"') {
+            parse_string();
+        } else if (c == '{' || c == '[') {
+            const char close = c == '{' ? '}' : ']';
+            ++m_pos;
+            while (!consume(close)) {
+                if (c == '{') {
+                    parse_string();
+                    expect(':');
+                }
+                skip_value();
+                consume(',');
+            }
+        } else {
+            parse_scalar();
+        }
+    }
+
+    std::string parse_string() {
+        expect('"');
+        const size_t end = m_text.find('"', m_pos);
+        if (end == std::string::npos) error("unterminated string");
+        std::string value = m_text.substr(m_pos, end - m_pos);
+        m_pos = end + 1;
+        return value;
+    }
+
+    std::string parse_scalar() {
+        skip_whitespace();
+        const size_t begin = m_pos;
+        while (m_pos < m_text.size() && (std::isalnum(static_cast<unsigned char>(m_text[m_pos]))
+                                         || m_text[m_pos] == '.' || m_text[m_pos] == '-' || m_text[m_pos] == '+')) {
+            ++m_pos;
+        }
+        if (begin == m_pos) error("value expected");
+        return m_text.substr(begin, m_pos - begin);
+    }
+
+    static std::string field(const Object& object, const std::string& key) {
+        auto it = object.find(key);
+        if (it == object.end()) throw std::runtime_error("Baseline entry without \"" + key + "\"");
+        return it->second;
+    }
+
+    void skip_whitespace() {
+        while (m_pos < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_pos]))) ++m_pos;
+    }
+
+    char peek() {
+        skip_whitespace();
+        return m_pos < m_text.size() ? m_text[m_pos] : '\0';
+    }
+
+    bool consume(char c) {
+        if (peek() == c) {
+            ++m_pos;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!consume(c)) error(std::string("'") + c + "' expected");
+    }
+
+    [[noreturn]] void error(const std::string& message) const {
+        throw std::runtime_error("Invalid baseline JSON at offset " + std::to_string(m_pos) + ": " + message);
+    }
+
+    std::string m_text;         ///< Document being parsed
+    size_t m_pos;               ///< Current offset in the document
+};
+
+/**
+ * @enum Verdict
+ * @brief Outcome of the comparison of one benchmark with its baseline
+ */
+enum class Verdict { NEW, MISSING, UNCHANGED, FASTER, SLOWER, IMPROVED, REGRESSION };
+
+inline const char* to_string(Verdict verdict) {
+    switch (verdict) {
+        case Verdict::NEW:        return "NEW";
+        case Verdict::MISSING:    return "MISSING";
+        case Verdict::UNCHANGED:  return "unchanged";
+        case Verdict::FASTER:     return "faster (within tolerance)";
+        case Verdict::SLOWER:     return "slower (within tolerance)";
+        case Verdict::IMPROVED:   return "IMPROVED";
+        case Verdict::REGRESSION: return "REGRESSION";
+    }
+    return "?";
+}
+
+/**
+ * @brief Compares a new measurement with its baseline
+ * @param baseline Stored statistics
+ * @param current Statistics of the new run
+ * @param tolerance Relative change ignored even when significant (e.g. 0.05)
+ * @return UNCHANGED when the difference is within the combined noise,
+ *         REGRESSION/IMPROVED when it exceeds tolerance beyond the noise,
+ *         SLOWER/FASTER otherwise
+ *
+ * The difference of the means is considered significant when it exceeds
+ * the combined half-width sqrt(ci_a^2 + ci_b^2) of both confidence
+ * intervals (a Welch-style approximation).
+ */
+inline Verdict compare(const BaselineEntry& baseline, const SampleStatistics& current, double tolerance) {
+    const double difference = current.mean - baseline.mean;
+    const double noise = std::sqrt(baseline.ci95 * baseline.ci95 + current.ci95 * current.ci95);
+    const double allowed = tolerance * baseline.mean;
+
+    if (std::abs(difference) <= noise) return Verdict::UNCHANGED;
+    if (difference - noise > allowed) return Verdict::REGRESSION;
+    if (-difference - noise > allowed) return Verdict::IMPROVED;
+    return difference > 0 ? Verdict::SLOWER : Verdict::FASTER;
+}
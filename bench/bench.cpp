@@ -0,0 +1,419 @@
+/**
+ * @file bench.cpp
+ * @brief Microbenchmarks of the solver kernels
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ *
+ * This program times the building blocks of the heat equation solver in
+ * isolation, over several grid sizes and thread counts:
+ * - the 7-point Laplacian sweep,
+ * - the evaluation of the force term f,
+ * - the reduction of the variation between two states,
+ * - Solution::initialize(g),
+ * - the shader-source pipeline (FunctionParser::parseFile + ShaderLoader::loadShaders).
+ *
+ * Each case is warmed up, then repeated; the summary statistics of the
+ * repetitions are printed and written as JSON.
+ *
+ * With --baseline, the results are compared with a stored results file
+ * (see baseline.hpp) and the program exits with status 2 if any benchmark
+ * regressed by more than --tolerance beyond the measurement noise. Sizes
+ * and thread counts default to those of the baseline.
+ *
+ * Usage (from the build directory, as the shaders are read from ../src):
+ *   bench [--sizes 32,64,128] [--threads 1,2,4] [--repetitions 10]
+ *         [--warmup 2] [--filter name] [--output bench.json]
+ *         [--baseline baseline.json] [--tolerance 0.05]
+ */
+
+#include "parameters.hpp"
+#include "solution.hpp"
+#include "force.hpp"
+#include "initial_condition.hpp"
+#include "function_parser.hpp"
+#include "shader_loader.hpp"
+#include "thread_pool.hpp"
+#include "statistics.hpp"
+#include "baseline.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef CONFIG_PATH
+    #define CONFIG_PATH "."  // Valeur par défaut pour l'éditeur
+#endif
+
+/**
+ * @struct BenchmarkOptions
+ * @brief Command-line options of the benchmark suite
+ */
+struct BenchmarkOptions {
+    std::vector<size_t> sizes = {32, 64, 128};          ///< Subdivisions per direction
+    std::vector<size_t> threads = {1};                  ///< Thread counts to sweep
+    int repetitions = 10;                               ///< Timed repetitions per case
+    int warmup = 2;                                     ///< Untimed repetitions per case
+    std::string filter;                                 ///< Only run benchmarks whose name contains this
+    std::string output = "bench.json";                  ///< JSON output file
+    std::string baseline;                               ///< Results file to compare with (empty = none)
+    double tolerance = 0.05;                            ///< Relative slowdown tolerated beyond noise
+    bool explicit_sizes = false;                        ///< --sizes was given
+    bool explicit_threads = false;                      ///< --threads was given
+};
+
+/**
+ * @struct BenchmarkResult
+ * @brief Timings of one (kernel, size, threads) case
+ */
+struct BenchmarkResult {
+    std::string name;           ///< Kernel name
+    size_t size;                ///< Subdivisions per direction (0 if grid-independent)
+    size_t threads;             ///< Number of threads
+    uint64_t updates;           ///< Lattice points processed per repetition
+    SampleStatistics stats;     ///< Timings in nanoseconds
+};
+
+/**
+ * @brief Times repeated calls of a function
+ * @param body Function to time
+ * @param options Number of warmup and timed repetitions
+ * @return Statistics of the timed repetitions, in nanoseconds
+ */
+static SampleStatistics measure(const std::function<void()>& body, const BenchmarkOptions& options) {
+    for (int r = 0; r < options.warmup; ++r) body();
+
+    std::vector<double> samples;
+    samples.reserve(options.repetitions);
+    for (int r = 0; r < options.repetitions; ++r) {
+        const auto start = std::chrono::steady_clock::now();
+        body();
+        const auto stop = std::chrono::steady_clock::now();
+        samples.push_back(static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count()));
+    }
+    return SampleStatistics::compute(samples);
+}
+
+// Kernels ─────────────────────────────────────────────────────────────────────
+
+/**
+ * @brief Laplacian of U on the interior points, written in V
+ */
+static void laplacian_sweep(ThreadPool& pool, const Parameters& params, const Solution& U, Solution& V) {
+    const size_t nx = params.getNx(), ny = params.getNy(), nz = params.getNz();
+    const double dx2 = params.getDx2(), dy2 = params.getDy2(), dz2 = params.getDz2();
+
+    pool.parallel_for(1, nz, [&](size_t k_begin, size_t k_end, size_t) {
+        for (size_t k = k_begin; k < k_end; ++k) {
+            for (size_t j = 1; j < ny; ++j) {
+                for (size_t i = 1; i < nx; ++i) {
+                    V(i, j, k) =
+                        (U(i+1,j,k) - 2*U(i,j,k) + U(i-1,j,k)) / dx2 +
+                        (U(i,j+1,k) - 2*U(i,j,k) + U(i,j-1,k)) / dy2 +
+                        (U(i,j,k+1) - 2*U(i,j,k) + U(i,j,k-1)) / dz2;
+                }
+            }
+        }
+    });
+}
+
+/**
+ * @brief Force term f on the interior points, written in V
+ */
+static void force_evaluation(ThreadPool& pool, const Parameters& params, Solution& V, double t) {
+    const size_t nx = params.getNx(), ny = params.getNy(), nz = params.getNz();
+    const double dx = params.getDx(), dy = params.getDy(), dz = params.getDz();
+
+    pool.parallel_for(1, nz, [&](size_t k_begin, size_t k_end, size_t) {
+        for (size_t k = k_begin; k < k_end; ++k) {
+            for (size_t j = 1; j < ny; ++j) {
+                for (size_t i = 1; i < nx; ++i) {
+                    V(i, j, k) = f(i * dx, j * dy, k * dz, t);
+                }
+            }
+        }
+    });
+}
+
+/**
+ * @brief Sum of |V - U| over the interior points
+ */
+static double variation_reduction(ThreadPool& pool, const Parameters& params, const Solution& U, const Solution& V) {
+    const size_t nx = params.getNx(), ny = params.getNy(), nz = params.getNz();
+    struct alignas(64) Partial { double value = 0.0; };
+    std::vector<Partial> partials(pool.size());
+
+    pool.parallel_for(1, nz, [&](size_t k_begin, size_t k_end, size_t worker) {
+        double sum = 0.0;
+        for (size_t k = k_begin; k < k_end; ++k) {
+            for (size_t j = 1; j < ny; ++j) {
+                for (size_t i = 1; i < nx; ++i) {
+                    sum += std::abs(V(i, j, k) - U(i, j, k));
+                }
+            }
+        }
+        partials[worker].value += sum;
+    });
+
+    double total = 0.0;
+    for (const auto& partial : partials) total += partial.value;
+    return total;
+}
+
+// Suite ───────────────────────────────────────────────────────────────────────
+
+static std::vector<size_t> parse_list(const std::string& text) {
+    std::vector<size_t> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) values.push_back(static_cast<size_t>(std::stoul(item)));
+    }
+    return values;
+}
+
+static BenchmarkOptions parse_options(int argc, char** argv) {
+    BenchmarkOptions options;
+    for (int a = 1; a < argc; ++a) {
+        const std::string arg = argv[a];
+        auto value = [&]() -> std::string {
+            if (a + 1 >= argc) throw std::runtime_error("Missing value for " + arg);
+            return argv[++a];
+        };
+        if (arg == "--sizes") { options.sizes = parse_list(value()); options.explicit_sizes = true; }
+        else if (arg == "--threads") { options.threads = parse_list(value()); options.explicit_threads = true; }
+        else if (arg == "--repetitions") options.repetitions = std::stoi(value());
+        else if (arg == "--warmup") options.warmup = std::stoi(value());
+        else if (arg == "--filter") options.filter = value();
+        else if (arg == "--output") options.output = value();
+        else if (arg == "--baseline") options.baseline = value();
+        else if (arg == "--tolerance") options.tolerance = std::stod(value());
+        else throw std::runtime_error("Unknown option " + arg);
+    }
+    if (options.repetitions < 2) throw std::runtime_error("At least 2 repetitions are required");
+    return options;
+}
+
+static bool selected(const BenchmarkOptions& options, const std::string& name) {
+    return options.filter.empty() || name.find(options.filter) != std::string::npos;
+}
+
+/**
+ * @brief Runs every selected benchmark
+ * @param options Sizes, thread counts and repetitions
+ * @return One result per (kernel, size, threads) case
+ */
+std::vector<BenchmarkResult> run_suite(const BenchmarkOptions& options) {
+    std::vector<BenchmarkResult> results;
+    Parameters params(std::string(CONFIG_PATH) + "/parameters.txt");
+
+    for (size_t n : options.sizes) {
+        std::ostringstream dt;
+        dt << std::scientific << std::setprecision(17) << 0.1 / (static_cast<double>(n) * n);
+        params.set({{"nx", std::to_string(n)}, {"ny", std::to_string(n)}, {"nz", std::to_string(n)},
+                    {"dt", dt.str()}});
+
+        Solution U(params);
+        Solution V(params);
+        U.initialize(g);
+        V.initialize(g);
+        const uint64_t interior = static_cast<uint64_t>(n - 1) * (n - 1) * (n - 1);
+
+        for (size_t threads : options.threads) {
+            ThreadPool pool(threads);
+            if (selected(options, "laplacian")) {
+                results.push_back({"laplacian", n, threads, interior,
+                    measure([&]() { laplacian_sweep(pool, params, U, V); }, options)});
+            }
+            if (selected(options, "force")) {
+                results.push_back({"force", n, threads, interior,
+                    measure([&]() { force_evaluation(pool, params, V, 0.0); }, options)});
+            }
+            if (selected(options, "reduction")) {
+                volatile double sink = 0.0;
+                results.push_back({"reduction", n, threads, interior,
+                    measure([&]() { sink = variation_reduction(pool, params, U, V); }, options)});
+                (void)sink;
+            }
+        }
+
+        // Solution::initialize is sequential
+        if (selected(options, "initialize")) {
+            results.push_back({"initialize", n, 1, static_cast<uint64_t>(params.getNtot()),
+                measure([&]() { U.initialize(g); }, options)});
+        }
+    }
+
+    if (selected(options, "shader_pipeline")) {
+        FunctionParser::ParserOptions forceOptions;
+        forceOptions.functionName = "f";
+        forceOptions.requiredParams = {"double", "double", "double", "double"};
+        FunctionParser::ParserOptions initOptions;
+        initOptions.functionName = "g";
+        initOptions.requiredParams = {"double", "double", "double"};
+
+        try {
+            results.push_back({"shader_pipeline", 0, 1, 0, measure([&]() {
+                auto parsedForce = FunctionParser::parseFile(std::string(CONFIG_PATH) + "/force.hpp", forceOptions);
+                auto parsedInit = FunctionParser::parseFile(std::string(CONFIG_PATH) + "/initial_condition.hpp", initOptions);
+                volatile size_t length = ShaderLoader::loadShaders(parsedForce.metalCode, parsedInit.metalCode).size();
+                (void)length;
+            }, options)});
+        } catch (const std::exception& e) {
+            std::cerr << "shader_pipeline skipped: " << e.what() << std::endl;
+        }
+    }
+    return results;
+}
+
+/**
+ * @brief Writes the results as JSON
+ */
+static void write_json(const std::string& filename, const BenchmarkOptions& options, const std::vector<BenchmarkResult>& results) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Impossible to open the file " + filename);
+    }
+
+    file << std::setprecision(6) << std::fixed;
+    file << "{\n  \"repetitions\": " << options.repetitions
+         << ",\n  \"warmup\": " << options.warmup
+         << ",\n  \"benchmarks\": [\n";
+    for (size_t r = 0; r < results.size(); ++r) {
+        const auto& result = results[r];
+        const auto& s = result.stats;
+        const double mlups = s.median > 0.0 ? result.updates / s.median * 1e3 : 0.0;
+        file << "    {\"name\": \"" << result.name << "\", \"size\": " << result.size
+             << ", \"threads\": " << result.threads << ", \"count\": " << s.count
+             << ", \"median_ns\": " << s.median << ", \"mean_ns\": " << s.mean
+             << ", \"stddev_ns\": " << s.stddev << ", \"ci95_ns\": " << s.ci95
+             << ", \"mad_ns\": " << s.mad << ", \"min_ns\": " << s.min << ", \"max_ns\": " << s.max
+             << ", \"mlups\": " << mlups << "}" << (r + 1 < results.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n}\n";
+}
+
+/**
+ * @brief Displays the results as a table
+ */
+static void display(const std::vector<BenchmarkResult>& results) {
+    std::cout << std::left << std::setw(18) << "Benchmark" << std::right
+              << std::setw(6) << "size" << std::setw(8) << "threads"
+              << std::setw(14) << "median ms" << std::setw(12) << "± ci95"
+              << std::setw(12) << "MAD" << std::setw(12) << "MLUPS" << "\n";
+    for (const auto& result : results) {
+        const auto& s = result.stats;
+        std::cout << std::left << std::setw(18) << result.name << std::right
+                  << std::setw(6) << result.size << std::setw(8) << result.threads
+                  << std::fixed << std::setprecision(3)
+                  << std::setw(14) << s.median * 1e-6 << std::setw(12) << s.ci95 * 1e-6
+                  << std::setw(12) << s.mad * 1e-6 << std::setprecision(1)
+                  << std::setw(12) << (s.median > 0.0 && result.updates ? result.updates / s.median * 1e3 : 0.0) << "\n";
+    }
+}
+
+/**
+ * @brief Whether run_suite runs the benchmark of a baseline entry with these options
+ */
+static bool expected(const BenchmarkOptions& options, const BaselineEntry& entry) {
+    if (!selected(options, entry.name)) return false;
+    if (entry.size == 0 || entry.name == "initialize") {
+        // Sans taille ou séquentiel : une seule exécution, hors de la boucle sur les threads
+        return entry.size == 0
+            || std::find(options.sizes.begin(), options.sizes.end(), entry.size) != options.sizes.end();
+    }
+    return std::find(options.sizes.begin(), options.sizes.end(), entry.size) != options.sizes.end()
+        && std::find(options.threads.begin(), options.threads.end(), entry.threads) != options.threads.end();
+}
+
+/**
+ * @brief Compares the results with the baseline and displays a verdict per benchmark
+ * @return true if at least one benchmark regressed, or a benchmark of the baseline
+ *         expected with these options produced no result (MISSING)
+ */
+static bool check_baseline(const std::vector<BaselineEntry>& baseline, const std::vector<BenchmarkResult>& results,
+                           const BenchmarkOptions& options) {
+    const double tolerance = options.tolerance;
+    auto key = [](const std::string& name, size_t size, size_t threads) {
+        return name + "/" + std::to_string(size) + "/" + std::to_string(threads);
+    };
+    std::map<std::string, const BaselineEntry*> stored;
+    for (const auto& entry : baseline) stored[key(entry.name, entry.size, entry.threads)] = &entry;
+
+    bool regressed = false;
+    std::cout << "\nComparison with baseline (tolerance " << std::setprecision(1) << tolerance * 100 << "%)\n"
+              << std::left << std::setw(28) << "Benchmark" << std::right
+              << std::setw(14) << "baseline ms" << std::setw(14) << "current ms" << std::setw(10) << "change"
+              << "  verdict\n";
+    for (const auto& result : results) {
+        const std::string name = key(result.name, result.size, result.threads);
+        auto it = stored.find(name);
+        std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(3);
+        if (it == stored.end()) {
+            std::cout << std::setw(14) << "-" << std::setw(14) << result.stats.mean * 1e-6
+                      << std::setw(10) << "-" << "  " << to_string(Verdict::NEW) << "\n";
+            continue;
+        }
+        const Verdict verdict = compare(*it->second, result.stats, tolerance);
+        regressed = regressed || verdict == Verdict::REGRESSION;
+        std::cout << std::setw(14) << it->second->mean * 1e-6 << std::setw(14) << result.stats.mean * 1e-6
+                  << std::setprecision(1) << std::setw(9) << 100.0 * (result.stats.mean / it->second->mean - 1.0) << "%"
+                  << "  " << to_string(verdict) << "\n";
+    }
+
+    // Benchmark renommé, supprimé ou en échec : absent des résultats courants
+    std::set<std::string> measured;
+    for (const auto& result : results) measured.insert(key(result.name, result.size, result.threads));
+    for (const auto& entry : baseline) {
+        const std::string name = key(entry.name, entry.size, entry.threads);
+        if (!expected(options, entry) || measured.count(name)) continue;
+        regressed = true;
+        std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(14) << entry.mean * 1e-6 << std::setw(14) << "-"
+                  << std::setw(10) << "-" << "  " << to_string(Verdict::MISSING) << "\n";
+    }
+    return regressed;
+}
+
+int main(int argc, char** argv) {
+    try {
+        BenchmarkOptions options = parse_options(argc, argv);
+
+        std::vector<BaselineEntry> baseline;
+        if (!options.baseline.empty()) {
+            baseline = BaselineReader::load(options.baseline);
+            if (baseline.empty()) {
+                throw std::runtime_error("the baseline " + options.baseline + " holds no benchmark, so nothing can be "
+                                         "checked; generate it on the reference machine with --output " + options.baseline);
+            }
+            std::set<size_t> sizes, threads;
+            for (const auto& entry : baseline) {
+                if (entry.size > 0) sizes.insert(entry.size);
+                threads.insert(entry.threads);
+            }
+            if (!options.explicit_sizes && !sizes.empty()) options.sizes.assign(sizes.begin(), sizes.end());
+            if (!options.explicit_threads && !threads.empty()) options.threads.assign(threads.begin(), threads.end());
+        }
+
+        const auto results = run_suite(options);
+        display(results);
+        write_json(options.output, options, results);
+        std::cout << "Results written to " << options.output << std::endl;
+
+        if (!options.baseline.empty() && check_baseline(baseline, results, options)) {
+            std::cerr << "bench: significant performance regression or missing benchmark detected" << std::endl;
+            return 2;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "bench: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,224 @@
+/**
+ * @file scaling.cpp
+ * @brief Strong- and weak-scaling study of the CPU solver
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ *
+ * This program runs HeatEquation for a sweep of thread counts, using
+ * Parameters overrides on top of src/config/parameters.txt:
+ * - strong scaling: the grid is fixed (--size), only the thread count varies;
+ * - weak scaling: the number of interior points per thread is fixed
+ *   (--points-per-worker) and the grid grows with the thread count.
+ *
+ * For each point of the sweep the median time of the time loop over
+ * several repetitions is reported together with the speed-up, parallel
+ * efficiency, MLUPS and load imbalance of the Laplacian phase (slowest
+ * worker's busy time over the mean), as a table and as a CSV file.
+ *
+ * Usage:
+ *   scaling [--mode strong|weak|both] [--threads 1,2,4,8] [--size 128]
+ *           [--points-per-worker 1000000] [--iterations 20]
+ *           [--repetitions 3] [--grain 0] [--output scaling]
+ */
+
+#include "parameters.hpp"
+#include "heat_equation.hpp"
+#include "force.hpp"
+#include "initial_condition.hpp"
+#include "statistics.hpp"
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef CONFIG_PATH
+    #define CONFIG_PATH "."  // Valeur par défaut pour l'éditeur
+#endif
+
+/**
+ * @struct ScalingOptions
+ * @brief Command-line options of the scaling study
+ */
+struct ScalingOptions {
+    std::string mode = "both";                  ///< "strong", "weak" or "both"
+    std::vector<size_t> threads = {1, 2, 4};    ///< Thread counts to sweep
+    size_t size = 128;                          ///< Subdivisions per direction (strong scaling)
+    size_t points_per_worker = 1000000;         ///< Interior points per thread (weak scaling)
+    int iterations = 20;                        ///< Time steps per run
+    int repetitions = 3;                        ///< Runs per point, the median is kept
+    size_t grain = 0;                           ///< schedule_grain of the solver (0 = static blocks)
+    std::string output = "scaling";             ///< Prefix of the CSV files
+};
+
+/**
+ * @struct ScalingPoint
+ * @brief Measurement of one point of the sweep
+ */
+struct ScalingPoint {
+    size_t threads;         ///< Number of threads
+    size_t size;            ///< Subdivisions per direction
+    uint64_t updates;       ///< Lattice updates per run
+    double seconds;         ///< Median time of the time loop
+    double speedup;         ///< Strong: T(1)/T(p); weak: p*T(1)/T(p) (scaled speed-up)
+    double efficiency;      ///< Strong: speed-up/p; weak: T(1)/T(p)
+    double mlups;           ///< Million lattice updates per second
+    double imbalance;       ///< Load imbalance of the Laplacian phase (max/mean busy time)
+};
+
+static std::vector<size_t> parse_list(const std::string& text) {
+    std::vector<size_t> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) values.push_back(static_cast<size_t>(std::stoul(item)));
+    }
+    return values;
+}
+
+static ScalingOptions parse_options(int argc, char** argv) {
+    ScalingOptions options;
+    for (int a = 1; a < argc; ++a) {
+        const std::string arg = argv[a];
+        auto value = [&]() -> std::string {
+            if (a + 1 >= argc) throw std::runtime_error("Missing value for " + arg);
+            return argv[++a];
+        };
+        if (arg == "--mode") options.mode = value();
+        else if (arg == "--threads") options.threads = parse_list(value());
+        else if (arg == "--size") options.size = std::stoul(value());
+        else if (arg == "--points-per-worker") options.points_per_worker = std::stoul(value());
+        else if (arg == "--iterations") options.iterations = std::stoi(value());
+        else if (arg == "--repetitions") options.repetitions = std::stoi(value());
+        else if (arg == "--grain") options.grain = std::stoul(value());
+        else if (arg == "--output") options.output = value();
+        else throw std::runtime_error("Unknown option " + arg);
+    }
+    if (options.mode != "strong" && options.mode != "weak" && options.mode != "both") {
+        throw std::runtime_error("Unknown mode " + options.mode);
+    }
+    if (options.threads.empty() || options.repetitions < 1 || options.iterations < 1) {
+        throw std::runtime_error("Invalid sweep");
+    }
+    return options;
+}
+
+/**
+ * @brief Runs the solver on an n^3 grid with the given number of threads
+ * @return Point with the median time of the time loop and imbalance over the repetitions
+ *         (speed-up, efficiency and MLUPS are filled by sweep)
+ */
+static ScalingPoint run(Parameters& params, size_t n, size_t threads, const ScalingOptions& options) {
+    std::ostringstream dt;
+    dt << std::scientific << std::setprecision(17) << 0.1 / (static_cast<double>(n) * n);
+    params.set({{"nx", std::to_string(n)}, {"ny", std::to_string(n)}, {"nz", std::to_string(n)},
+                {"dt", dt.str()},
+                {"max_iterations", std::to_string(options.iterations)},
+                {"output_frequency", "0"},
+                {"num_threads", std::to_string(threads)},
+                {"schedule_grain", std::to_string(options.grain)}});
+
+    std::vector<double> samples;
+    std::vector<double> imbalances;
+    for (int r = 0; r < options.repetitions; ++r) {
+        HeatEquation equation(params, f, g);
+        equation.solve();
+        samples.push_back(equation.timers("Calculation").get_elapsed_seconds()
+                          + equation.timers("Others").get_elapsed_seconds()
+                          + equation.timers("I/O").get_elapsed_seconds());
+        imbalances.push_back(equation.thread_pool().profile().at("Laplacian").imbalance());
+    }
+    ScalingPoint point;
+    point.threads = threads;
+    point.size = n;
+    point.updates = static_cast<uint64_t>(n - 1) * (n - 1) * (n - 1) * options.iterations;
+    point.seconds = SampleStatistics::compute(samples).median;
+    point.imbalance = SampleStatistics::compute(imbalances).median;
+    return point;
+}
+
+/**
+ * @brief Sweeps the thread counts for one scaling mode
+ * @param weak true for weak scaling, false for strong scaling
+ */
+static std::vector<ScalingPoint> sweep(Parameters& params, bool weak, const ScalingOptions& options) {
+    std::vector<ScalingPoint> points;
+    double reference = 0.0;
+    size_t reference_threads = 0;
+
+    for (size_t threads : options.threads) {
+        size_t n = options.size;
+        if (weak) {
+            // (n-1)^3 interior points ~ points_per_worker * threads
+            n = static_cast<size_t>(std::llround(std::cbrt(static_cast<double>(options.points_per_worker) * threads))) + 1;
+        }
+        ScalingPoint point = run(params, n, threads, options);
+        const double seconds = point.seconds;
+        if (points.empty()) {
+            reference = seconds;
+            reference_threads = threads;
+        }
+
+        const double ratio = seconds > 0.0 ? reference / seconds : 0.0;
+        const double relative_threads = static_cast<double>(threads) / reference_threads;
+        point.speedup = weak ? relative_threads * ratio : ratio;
+        point.efficiency = weak ? ratio : ratio / relative_threads;
+        point.mlups = seconds > 0.0 ? point.updates / seconds * 1e-6 : 0.0;
+        points.push_back(point);
+
+        std::cerr << (weak ? "weak" : "strong") << ": " << threads << " thread(s), " << n << "^3 done" << std::endl;
+    }
+    return points;
+}
+
+/**
+ * @brief Displays a sweep as a table and writes it as CSV
+ */
+static void report(const std::string& title, const std::vector<ScalingPoint>& points, const std::string& filename) {
+    std::cout << "\n" << title << " (speed-up and efficiency relative to " << points.front().threads << " thread(s))\n"
+              << std::left << std::setw(9) << "threads" << std::right << std::setw(8) << "grid"
+              << std::setw(12) << "time s" << std::setw(10) << "speed-up"
+              << std::setw(12) << "efficiency" << std::setw(10) << "MLUPS" << std::setw(11) << "imbalance" << "\n";
+    for (const auto& p : points) {
+        std::cout << std::left << std::setw(9) << p.threads << std::right << std::setw(8) << p.size
+                  << std::fixed << std::setprecision(4) << std::setw(12) << p.seconds
+                  << std::setprecision(2) << std::setw(10) << p.speedup
+                  << std::setw(11) << 100.0 * p.efficiency << "%"
+                  << std::setprecision(1) << std::setw(10) << p.mlups
+                  << std::setprecision(3) << std::setw(11) << p.imbalance << "\n";
+    }
+
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Impossible to open the file " + filename);
+    }
+    file << "threads,size,updates,seconds,speedup,efficiency,mlups,imbalance\n" << std::setprecision(9);
+    for (const auto& p : points) {
+        file << p.threads << "," << p.size << "," << p.updates << "," << p.seconds << ","
+             << p.speedup << "," << p.efficiency << "," << p.mlups << "," << p.imbalance << "\n";
+    }
+    std::cout << "Written to " << filename << std::endl;
+}
+
+int main(int argc, char** argv) {
+    try {
+        const ScalingOptions options = parse_options(argc, argv);
+        Parameters params(std::string(CONFIG_PATH) + "/parameters.txt");
+
+        if (options.mode != "weak") {
+            report("Strong scaling, " + std::to_string(options.size) + "^3 grid",
+                   sweep(params, false, options), options.output + "_strong.csv");
+        }
+        if (options.mode != "strong") {
+            report("Weak scaling, " + std::to_string(options.points_per_worker) + " points per thread",
+                   sweep(params, true, options), options.output + "_weak.csv");
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "scaling: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file statistics.hpp
+ * @brief Robust summary statistics of benchmark repetitions
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ *
+ * This utility summarizes the timings of repeated benchmark runs with
+ * both classical (mean, standard deviation, confidence interval of the
+ * mean) and robust (median, median absolute deviation) estimators.
+ */
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @struct SampleStatistics
+ * @brief Summary of a set of timings, in nanoseconds
+ */
+struct SampleStatistics {
+    size_t count = 0;       ///< Number of repetitions
+    double median = 0.0;    ///< Median timing
+    double mean = 0.0;      ///< Arithmetic mean
+    double stddev = 0.0;    ///< Sample standard deviation
+    double ci95 = 0.0;      ///< Half-width of the 95% confidence interval of the mean
+    double mad = 0.0;       ///< Median absolute deviation (scaled to estimate sigma)
+    double min = 0.0;       ///< Fastest repetition
+    double max = 0.0;       ///< Slowest repetition
+
+    /**
+     * @brief Two-sided 95% Student t quantile
+     * @param dof Degrees of freedom
+     */
+    static double student_t95(size_t dof) {
+        static const double table[] = {
+            0.0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+            2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+            2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+        };
+        if (dof == 0) return 0.0;
+        if (dof <= 30) return table[dof];
+        return 1.96 + 2.4 / static_cast<double>(dof);
+    }
+
+    /**
+     * @brief Computes the statistics of a set of samples
+     * @param samples Timings in nanoseconds (copied, as they are sorted)
+     */
+    static SampleStatistics compute(std::vector<double> samples) {
+        SampleStatistics stats;
+        stats.count = samples.size();
+        if (samples.empty()) return stats;
+
+        std::sort(samples.begin(), samples.end());
+        auto median_of_sorted = [](const std::vector<double>& sorted) {
+            const size_t n = sorted.size();
+            return n % 2 ? sorted[n / 2] : 0.5 * (sorted[n / 2 - 1] + sorted[n / 2]);
+        };
+
+        stats.min = samples.front();
+        stats.max = samples.back();
+        stats.median = median_of_sorted(samples);
+
+        double sum = 0.0;
+        for (double s : samples) sum += s;
+        stats.mean = sum / samples.size();
+
+        if (samples.size() > 1) {
+            double squares = 0.0;
+            for (double s : samples) squares += (s - stats.mean) * (s - stats.mean);
+            stats.stddev = std::sqrt(squares / (samples.size() - 1));
+            stats.ci95 = student_t95(samples.size() - 1) * stats.stddev / std::sqrt(static_cast<double>(samples.size()));
+        }
+
+        std::vector<double> deviations;
+        deviations.reserve(samples.size());
+        for (double s : samples) deviations.push_back(std::abs(s - stats.median));
+        std::sort(deviations.begin(), deviations.end());
+        stats.mad = 1.4826 * median_of_sorted(deviations);
+
+        return stats;
+    }
+};
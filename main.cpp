@@ -48,12 +48,15 @@ int main() {
     // std::cout << "Begin solving CPU ───────────────────────────────────────────"<< std::endl;
     // cpu_equation.solve();
     // cpu_equation.timers.display();
+    // cpu_equation.display_throughput();
+    // cpu_equation.display_load_balance();
 
     // // GPU solution using Metal
     MetalHeatEquation metal_equation(params, f, g);
     std::cout << "Begin solving GPU ───────────────────────────────────────────" << std::endl;
     metal_equation.solve();
     metal_equation.timers.display();
+    metal_equation.display_throughput();
 
     return 0;
 }
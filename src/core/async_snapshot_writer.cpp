@@ -0,0 +1,155 @@
+/**
+ * @file async_snapshot_writer.cpp
+ * @brief Implementation of the AsyncSnapshotWriter class methods
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ */
+
+#include "async_snapshot_writer.hpp"
+#include "snapshot.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+long long elapsed_ns(Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+}
+
+/**
+ * @brief Waits between two polls of a queue: yields first, then sleeps
+ */
+void backoff(unsigned& attempts) {
+    if (++attempts < 64) {
+        std::this_thread::yield();
+    } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+}
+
+}  // namespace
+
+AsyncSnapshotWriter::AsyncSnapshotWriter(const Parameters& params, size_t buffers, uint32_t precision, uint32_t levels)
+    : params(params)
+    , precision(precision)
+    , levels(levels)
+    , pending(std::max<size_t>(1, buffers))
+    , available(std::max<size_t>(1, buffers))
+    , stopping(false)
+    , inFlight(0)
+    , m_writeNs(0)
+    , m_files(0)
+    , m_stallNs(0)
+    , m_copyNs(0)
+{
+    for (size_t b = 0; b < std::max<size_t>(1, buffers); ++b) {
+        staging.push_back(std::make_unique<Solution>(this->params, "Output staging"));
+        size_t index = b;
+        available.try_push(index);
+    }
+    thread = std::thread(&AsyncSnapshotWriter::run, this);
+}
+
+AsyncSnapshotWriter::~AsyncSnapshotWriter() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping.store(true);
+    }
+    wake.notify_one();
+    if (thread.joinable()) thread.join();
+}
+
+void AsyncSnapshotWriter::submit(const Solution& solution, const std::string& filename, double time, uint64_t iteration) {
+    rethrow_error();
+
+    // Attente d'un buffer libre : c'est le seul moment où le solveur est bloqué
+    const auto wait_start = Clock::now();
+    size_t buffer = 0;
+    unsigned attempts = 0;
+    while (!available.try_pop(buffer)) {
+        rethrow_error();
+        backoff(attempts);
+    }
+    m_stallNs += elapsed_ns(wait_start);
+
+    const auto copy_start = Clock::now();
+    {
+        TRACE_SCOPE("Snapshot staging copy");
+        std::copy(solution.get_data(), solution.get_data() + solution.size(), staging[buffer]->get_data());
+    }
+    m_copyNs += elapsed_ns(copy_start);
+
+    Job job;
+    job.buffer = buffer;
+    job.filename = filename;
+    job.time = time;
+    job.iteration = iteration;
+    inFlight.fetch_add(1);
+    pending.try_push(job);  // Jamais plein : au plus un job par buffer
+    {
+        // Le verrou ordonne le push avant le test du writer : pas de réveil perdu
+        std::lock_guard<std::mutex> lock(wakeMutex);
+    }
+    wake.notify_one();
+}
+
+void AsyncSnapshotWriter::flush() {
+    const auto wait_start = Clock::now();
+    unsigned attempts = 0;
+    while (inFlight.load() > 0) {
+        rethrow_error();
+        backoff(attempts);
+    }
+    m_stallNs += elapsed_ns(wait_start);
+    rethrow_error();
+}
+
+/**
+ * @brief Thread body: writes queued snapshots until stopped and idle
+ *
+ * Between outputs the queue stays empty: after a short spin the thread
+ * sleeps on the condition variable instead of polling.
+ */
+void AsyncSnapshotWriter::run() {
+    unsigned attempts = 0;
+    for (;;) {
+        Job job;
+        if (!pending.try_pop(job)) {
+            if (stopping.load() && pending.empty()) return;
+            if (++attempts < 64) {
+                std::this_thread::yield();
+            } else {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                wake.wait(lock, [this] { return !pending.empty() || stopping.load(); });
+            }
+            continue;
+        }
+        attempts = 0;
+
+        const auto write_start = Clock::now();
+        try {
+            TRACE_SCOPE("Snapshot write");
+            Snapshot::write(job.filename, *staging[job.buffer], params, job.time, job.iteration, precision, levels);
+            m_files.fetch_add(1);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) error = std::current_exception();
+        }
+        m_writeNs.fetch_add(elapsed_ns(write_start));
+
+        available.try_push(job.buffer);
+        inFlight.fetch_sub(1);
+    }
+}
+
+void AsyncSnapshotWriter::rethrow_error() {
+    std::lock_guard<std::mutex> lock(errorMutex);
+    if (error) {
+        std::exception_ptr failure = error;
+        error = nullptr;
+        std::rethrow_exception(failure);
+    }
+}
@@ -0,0 +1,107 @@
+/**
+ * @file async_snapshot_writer.hpp
+ * @brief Background thread writing snapshots while the solver keeps computing
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ *
+ * At an output step the solver copies U_current into a recycled staging
+ * Solution and hands it to the writer thread through a lock-free SPSC
+ * queue; the writer returns the buffer through a second queue once the
+ * snapshot is on disk. The solver only waits (stalls) when every staging
+ * buffer is still being written.
+ */
+
+#ifndef ASYNC_SNAPSHOT_WRITER_HPP
+#define ASYNC_SNAPSHOT_WRITER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "parameters.hpp"
+#include "solution.hpp"
+#include "spsc_queue.hpp"
+
+/**
+ * @class AsyncSnapshotWriter
+ * @brief Double-buffered (or more) asynchronous snapshot output
+ */
+class AsyncSnapshotWriter {
+public:
+    /**
+     * @brief Starts the writer thread
+     * @param params Parameters of the grid
+     * @param buffers Number of staging buffers (2 = double buffering)
+     * @param precision Bytes per value of the snapshots (see Snapshot::write)
+     * @param levels Downsampled levels of the snapshots (see Snapshot::write)
+     */
+    AsyncSnapshotWriter(const Parameters& params, size_t buffers, uint32_t precision, uint32_t levels = 0);
+
+    /**
+     * @brief Writes the pending snapshots and stops the thread
+     */
+    ~AsyncSnapshotWriter();
+
+    AsyncSnapshotWriter(const AsyncSnapshotWriter&) = delete;
+    AsyncSnapshotWriter& operator=(const AsyncSnapshotWriter&) = delete;
+
+    /**
+     * @brief Queues a snapshot of solution (solver thread only)
+     *
+     * The values are copied into a free staging buffer, waiting for one
+     * if all of them are in flight.
+     * @throw The error of a previous write, if any
+     */
+    void submit(const Solution& solution, const std::string& filename, double time, uint64_t iteration);
+
+    /**
+     * @brief Waits until every queued snapshot is written (solver thread only)
+     * @throw The error of a previous write, if any
+     */
+    void flush();
+
+    double write_seconds() const { return m_writeNs.load() * 1e-9; }  ///< Time spent writing, in background
+    double stall_seconds() const { return m_stallNs * 1e-9; }         ///< Time the solver waited for the writer
+    double copy_seconds() const { return m_copyNs * 1e-9; }           ///< Time copying into staging buffers
+    uint64_t files() const { return m_files.load(); }                 ///< Snapshots written
+
+private:
+    /**
+     * @struct Job
+     * @brief Snapshot waiting in a staging buffer
+     */
+    struct Job {
+        size_t buffer = 0;
+        std::string filename;
+        double time = 0.0;
+        uint64_t iteration = 0;
+    };
+
+    void run();
+    void rethrow_error();
+
+    Parameters params;                                  ///< Grid of the snapshots
+    uint32_t precision;                                 ///< Bytes per value
+    uint32_t levels;                                    ///< Downsampled levels
+    std::vector<std::unique_ptr<Solution>> staging;     ///< Recycled staging buffers
+    SpscQueue<Job> pending;                             ///< Solver -> writer
+    SpscQueue<size_t> available;                        ///< Writer -> solver (free buffers)
+    std::atomic<bool> stopping;                         ///< Asks the thread to exit once idle
+    std::atomic<size_t> inFlight;                       ///< Submitted but not yet written
+    std::atomic<long long> m_writeNs;                   ///< Background write time
+    std::atomic<uint64_t> m_files;                      ///< Snapshots written
+    long long m_stallNs;                                ///< Solver wait time (solver thread)
+    long long m_copyNs;                                 ///< Staging copy time (solver thread)
+    std::mutex wakeMutex;                               ///< Guards the sleep of the writer
+    std::condition_variable wake;                       ///< Signalled by submit() and the stop request
+    std::mutex errorMutex;                              ///< Guards error
+    std::exception_ptr error;                           ///< First failure of the writer
+    std::thread thread;                                 ///< Writer thread
+};
+
+#endif
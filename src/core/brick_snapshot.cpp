@@ -0,0 +1,386 @@
+/**
+ * @file brick_snapshot.cpp
+ * @brief Implementation of the BrickSnapshot class methods
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ */
+
+#include "brick_snapshot.hpp"
+#include "file_writer.hpp"
+#include "codec.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+
+constexpr char BrickHeader::MAGIC[8];
+
+namespace {
+
+/**
+ * @brief 3D Lorenzo prediction of point (i, j, k) of a brick from its reconstructed neighbours
+ *
+ * Neighbours outside the brick count as 0, so bricks stay independent.
+ */
+double lorenzo(const std::vector<double>& r, size_t bx, size_t by, size_t i, size_t j, size_t k) {
+    auto at = [&](size_t di, size_t dj, size_t dk) {
+        return (i < di || j < dj || k < dk) ? 0.0 : r[(i - di) + bx * ((j - dj) + by * (k - dk))];
+    };
+    return at(1, 0, 0) + at(0, 1, 0) + at(0, 0, 1)
+         - at(1, 1, 0) - at(1, 0, 1) - at(0, 1, 1)
+         + at(1, 1, 1);
+}
+
+/**
+ * @brief Lossy encoding: [error bound][outliers][zlib(shuffled codes, outliers)]
+ *
+ * Prediction uses the reconstructed values, as the decoder does, so the
+ * quantization error does not accumulate along the brick.
+ */
+void encode_lossy(const std::vector<double>& values, const BrickRegion& r, double error_bound, int level,
+                  std::vector<uint8_t>& out, double& max_error) {
+    const size_t bx = r.i1 - r.i0 + 1;
+    const size_t by = r.j1 - r.j0 + 1;
+    const size_t bz = r.k1 - r.k0 + 1;
+    const double step = 2.0 * error_bound;
+
+    std::vector<double> reconstructed(values.size());
+    std::vector<uint32_t> codes(values.size());
+    std::vector<double> outliers;
+    for (size_t k = 0, n = 0; k < bz; ++k) {
+        for (size_t j = 0; j < by; ++j) {
+            for (size_t i = 0; i < bx; ++i, ++n) {
+                const double prediction = lorenzo(reconstructed, bx, by, i, j, k);
+                const double q = std::nearbyint((values[n] - prediction) / step);
+                const double value = prediction + step * q;
+                if (std::isfinite(q) && std::fabs(q) < Codec::MAX_QUANTUM && std::fabs(value - values[n]) <= error_bound) {
+                    codes[n] = Codec::zigzag(static_cast<long long>(q));
+                    reconstructed[n] = value;
+                    max_error = std::max(max_error, std::fabs(value - values[n]));
+                } else {
+                    codes[n] = Codec::OUTLIER;
+                    reconstructed[n] = values[n];
+                    outliers.push_back(values[n]);
+                }
+            }
+        }
+    }
+
+    std::vector<uint8_t> payload(codes.size() * sizeof(uint32_t) + outliers.size() * sizeof(double));
+    Codec::shuffle(codes.data(), codes.size(), sizeof(uint32_t), payload.data());
+    if (!outliers.empty()) {
+        // outliers.data() peut être nul quand il n'y a aucun outlier
+        std::memcpy(payload.data() + codes.size() * sizeof(uint32_t), outliers.data(), outliers.size() * sizeof(double));
+    }
+
+    const uint64_t count = outliers.size();
+    const size_t prefix = sizeof(double) + sizeof(uint64_t);
+    if (!Codec::deflate(payload.data(), payload.size(), level, out, prefix)) {
+        throw std::runtime_error("Lossy brick compression failed");
+    }
+    std::memcpy(out.data(), &error_bound, sizeof(double));
+    std::memcpy(out.data() + sizeof(double), &count, sizeof(uint64_t));
+}
+
+void decode_lossy(const std::vector<uint8_t>& stored, const BrickRegion& r, std::vector<double>& values) {
+    const size_t prefix = sizeof(double) + sizeof(uint64_t);
+    if (stored.size() < prefix) throw std::runtime_error("truncated");
+    double error_bound;
+    uint64_t count;
+    std::memcpy(&error_bound, stored.data(), sizeof(double));
+    std::memcpy(&count, stored.data() + sizeof(double), sizeof(uint64_t));
+    if (count > values.size()) throw std::runtime_error("too many outliers");
+
+    std::vector<uint8_t> payload(values.size() * sizeof(uint32_t) + count * sizeof(double));
+    if (!Codec::inflate(stored.data() + prefix, stored.size() - prefix, payload.data(), payload.size())) {
+        throw std::runtime_error("inflate");
+    }
+    std::vector<uint32_t> codes(values.size());
+    Codec::unshuffle(payload.data(), codes.size(), sizeof(uint32_t), codes.data());
+    const double* outliers = reinterpret_cast<const double*>(payload.data() + codes.size() * sizeof(uint32_t));
+
+    const size_t bx = r.i1 - r.i0 + 1;
+    const size_t by = r.j1 - r.j0 + 1;
+    const size_t bz = r.k1 - r.k0 + 1;
+    const double step = 2.0 * error_bound;
+    size_t next = 0;
+    for (size_t k = 0, n = 0; k < bz; ++k) {
+        for (size_t j = 0; j < by; ++j) {
+            for (size_t i = 0; i < bx; ++i, ++n) {
+                if (codes[n] == Codec::OUTLIER) {
+                    if (next == count) throw std::runtime_error("missing outlier");
+                    std::memcpy(&values[n], outliers + next++, sizeof(double));
+                } else {
+                    values[n] = lorenzo(values, bx, by, i, j, k) + step * static_cast<double>(Codec::unzigzag(codes[n]));
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Gathers and compresses one brick, lossy when error_bound > 0
+ */
+uint32_t encode_brick(const Solution& solution, const BrickRegion& r, int level, double error_bound,
+                      std::vector<uint8_t>& out, double& max_error) {
+    std::vector<double> values;
+    BrickSnapshot::gather(solution, r, values);
+    if (error_bound > 0.0) {
+        double brick_error = 0.0;
+        encode_lossy(values, r, error_bound, level, out, brick_error);
+        if (out.size() < values.size() * sizeof(double)) {
+            max_error = std::max(max_error, brick_error);
+            return BrickIndexEntry::CODEC_LORENZO_ZLIB;
+        }
+    }
+    return BrickSnapshot::encode(values, level, out);
+}
+
+bool intersects(const BrickRegion& a, const BrickRegion& b) {
+    return a.i0 <= b.i1 && b.i0 <= a.i1 && a.j0 <= b.j1 && b.j0 <= a.j1 && a.k0 <= b.k1 && b.k0 <= a.k1;
+}
+
+/**
+ * @brief Decompresses every brick intersecting region and passes it with its extent to visit
+ */
+void for_each_brick(const std::string& filename, const BrickRegion& region,
+                    const std::function<void(const BrickRegion&, const std::vector<double>&)>& visit) {
+    const BrickHeader header = BrickSnapshot::read_header(filename);
+    const BrickGrid grid(header.nx, header.ny, header.nz, header.brick_size);
+    if (region.i0 > region.i1 || region.j0 > region.j1 || region.k0 > region.k1
+        || region.i1 >= grid.points[0] || region.j1 >= grid.points[1] || region.k1 >= grid.points[2]) {
+        throw std::runtime_error(filename + ": requested region is outside the grid");
+    }
+
+    std::ifstream file(filename, std::ios::binary);
+    std::vector<BrickIndexEntry> index(header.bricks);
+    file.seekg(header.index_offset);
+    file.read(reinterpret_cast<char*>(index.data()), index.size() * sizeof(BrickIndexEntry));
+
+    std::vector<uint8_t> stored;
+    std::vector<double> values;
+    for (size_t b = 0; b < header.bricks; ++b) {
+        const BrickRegion brick = grid.region(b);
+        if (!intersects(brick, region)) continue;
+
+        stored.resize(index[b].bytes);
+        file.seekg(index[b].offset);
+        file.read(reinterpret_cast<char*>(stored.data()), stored.size());
+        if (!file) {
+            throw std::runtime_error("Error while reading the file " + filename);
+        }
+
+        try {
+            BrickSnapshot::decode(stored, index[b].codec, brick, values);
+        } catch (const std::runtime_error&) {
+            throw std::runtime_error(filename + ": corrupted brick " + std::to_string(b));
+        }
+        visit(brick, values);
+    }
+}
+
+}  // namespace
+
+void BrickSnapshot::gather(const Solution& solution, const BrickRegion& region, std::vector<double>& values) {
+    values.resize(region.count());
+    size_t index = 0;
+    for (size_t k = region.k0; k <= region.k1; ++k)
+        for (size_t j = region.j0; j <= region.j1; ++j)
+            for (size_t i = region.i0; i <= region.i1; ++i)
+                values[index++] = solution(i, j, k);
+}
+
+void BrickSnapshot::scatter(const std::vector<double>& values, const BrickRegion& region, Solution& solution) {
+    size_t index = 0;
+    for (size_t k = region.k0; k <= region.k1; ++k)
+        for (size_t j = region.j0; j <= region.j1; ++j)
+            for (size_t i = region.i0; i <= region.i1; ++i)
+                solution(i, j, k) = values[index++];
+}
+
+uint32_t BrickSnapshot::encode(const std::vector<double>& values, int level, std::vector<uint8_t>& out) {
+    const size_t raw = values.size() * sizeof(double);
+    std::vector<uint8_t> shuffled(raw);
+    Codec::shuffle(values.data(), values.size(), sizeof(double), shuffled.data());
+    if (Codec::deflate(shuffled.data(), raw, level, out) && out.size() < raw) {
+        return BrickIndexEntry::CODEC_SHUFFLE_ZLIB;
+    }
+    out.assign(reinterpret_cast<const uint8_t*>(values.data()), reinterpret_cast<const uint8_t*>(values.data()) + raw);
+    return BrickIndexEntry::CODEC_RAW;
+}
+
+void BrickSnapshot::decode(const std::vector<uint8_t>& stored, uint32_t codec, const BrickRegion& region,
+                           std::vector<double>& values) {
+    const size_t raw = region.count() * sizeof(double);
+    values.resize(region.count());
+    if (codec == BrickIndexEntry::CODEC_RAW && stored.size() == raw) {
+        std::memcpy(values.data(), stored.data(), raw);
+    } else if (codec == BrickIndexEntry::CODEC_SHUFFLE_ZLIB) {
+        std::vector<uint8_t> shuffled(raw);
+        if (!Codec::inflate(stored.data(), stored.size(), shuffled.data(), raw)) {
+            throw std::runtime_error("corrupted brick");
+        }
+        Codec::unshuffle(shuffled.data(), values.size(), sizeof(double), values.data());
+    } else if (codec == BrickIndexEntry::CODEC_LORENZO_ZLIB) {
+        decode_lossy(stored, region, values);
+    } else {
+        throw std::runtime_error("invalid brick codec " + std::to_string(codec));
+    }
+}
+
+BrickOptions BrickOptions::from_parameters(const Parameters& params) {
+    BrickOptions options;
+    options.brick_size = static_cast<size_t>(std::max(1L, params.getInt("brick_size", static_cast<long>(options.brick_size))));
+    if (BrickGrid(params.getNx(), params.getNy(), params.getNz(), options.brick_size).max_brick_bytes() > UINT32_MAX) {
+        throw std::runtime_error("brick_size " + std::to_string(options.brick_size) + " is too large (bricks over 4 GiB)");
+    }
+    options.level = static_cast<int>(params.getInt("brick_level", options.level));
+    options.abs_error = params.getDouble("lossy_abs_error", options.abs_error);
+    options.rel_error = params.getDouble("lossy_rel_error", options.rel_error);
+    if (options.abs_error < 0.0 || options.rel_error < 0.0) {
+        throw std::runtime_error("Lossy error bounds must be positive");
+    }
+    return options;
+}
+
+/**
+ * @brief Implementation of the container writer
+ *
+ * Bricks are compressed in parallel into memory (at most the raw size of
+ * the grid), so the index is known before the file is written in one
+ * sequential pass. A relative bound is turned into an absolute one with
+ * the value range of the grid; with both bounds, the tighter one is used.
+ */
+BrickStats BrickSnapshot::write(const std::string& filename, const Solution& solution, const Parameters& params,
+                                double time, uint64_t iteration, ThreadPool& pool, const BrickOptions& options) {
+    if (options.brick_size == 0) {
+        throw std::runtime_error("Brick size must be positive");
+    }
+    const BrickGrid grid(params.getNx(), params.getNy(), params.getNz(), options.brick_size);
+    if (grid.max_brick_bytes() > UINT32_MAX) {
+        // La taille stockée d'une brique tient sur 32 bits dans l'index
+        throw std::runtime_error("Brick size " + std::to_string(options.brick_size) + " is too large (bricks over 4 GiB)");
+    }
+    const size_t bricks = grid.bricks();
+
+    double error_bound = options.abs_error;
+    if (options.rel_error > 0.0) {
+        double low = solution(0, 0, 0);
+        double high = low;
+        for (size_t k = 0; k < grid.points[2]; ++k)
+            for (size_t j = 0; j < grid.points[1]; ++j)
+                for (size_t i = 0; i < grid.points[0]; ++i) {
+                    low = std::min(low, solution(i, j, k));
+                    high = std::max(high, solution(i, j, k));
+                }
+        const double relative = options.rel_error * (high - low);
+        error_bound = error_bound > 0.0 ? std::min(error_bound, relative) : relative;
+    }
+
+    std::vector<std::vector<uint8_t>> encoded(bricks);
+    std::vector<BrickIndexEntry> index(bricks);
+    std::vector<double> worker_error(pool.size(), 0.0);
+    pool.parallel_for(0, bricks, [&](size_t first, size_t last, size_t worker) {
+        for (size_t b = first; b < last; ++b) {
+            index[b].codec = encode_brick(solution, grid.region(b), options.level, error_bound,
+                                          encoded[b], worker_error[worker]);
+        }
+    }, "Brick compression", 1);
+
+    BrickHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, BrickHeader::MAGIC, sizeof(header.magic));
+    header.version = BrickHeader::VERSION;
+    header.endian_check = BrickHeader::ENDIAN_CHECK;
+    header.nx = params.getNx();
+    header.ny = params.getNy();
+    header.nz = params.getNz();
+    header.brick_size = options.brick_size;
+    header.bricks = bricks;
+    header.dx = params.getDx();
+    header.dy = params.getDy();
+    header.dz = params.getDz();
+    header.time = time;
+    header.iteration = iteration;
+    header.index_offset = sizeof(BrickHeader);
+
+    uint64_t offset = header.index_offset + bricks * sizeof(BrickIndexEntry);
+    for (size_t b = 0; b < bricks; ++b) {
+        index[b].offset = offset;
+        index[b].bytes = static_cast<uint32_t>(encoded[b].size());
+        offset += encoded[b].size();
+    }
+
+    std::unique_ptr<FileWriter> file = FileWriter::open(filename, IoOptions::from_parameters(params));
+    file->write(&header, sizeof(header));
+    file->write(index.data(), index.size() * sizeof(BrickIndexEntry));
+    for (const std::vector<uint8_t>& brick : encoded) {
+        file->write(brick.data(), brick.size());
+    }
+    file->close();
+
+    BrickStats stats;
+    stats.raw_bytes = static_cast<uint64_t>(grid.points[0]) * grid.points[1] * grid.points[2] * sizeof(double);
+    stats.stored_bytes = offset;
+    stats.bricks = bricks;
+    stats.error_bound = error_bound;
+    stats.max_error = *std::max_element(worker_error.begin(), worker_error.end());
+    return stats;
+}
+
+BrickHeader BrickSnapshot::read_header(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Impossible to open the file " + filename);
+    }
+    BrickHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, BrickHeader::MAGIC, sizeof(header.magic)) != 0) {
+        throw std::runtime_error(filename + " is not a brick snapshot");
+    }
+    if (header.version != BrickHeader::VERSION) {
+        throw std::runtime_error(filename + ": unsupported brick snapshot version " + std::to_string(header.version));
+    }
+    if (header.endian_check != BrickHeader::ENDIAN_CHECK) {
+        throw std::runtime_error(filename + ": brick snapshot written with another byte order");
+    }
+    if (header.brick_size == 0
+        || header.bricks != BrickGrid(header.nx, header.ny, header.nz, header.brick_size).bricks()) {
+        throw std::runtime_error(filename + ": inconsistent brick snapshot header");
+    }
+
+    file.seekg(0, std::ios::end);
+    if (static_cast<uint64_t>(file.tellg()) < header.index_offset + header.bricks * sizeof(BrickIndexEntry)) {
+        throw std::runtime_error(filename + ": truncated brick snapshot");
+    }
+    return header;
+}
+
+std::vector<double> BrickSnapshot::read_region(const std::string& filename, const BrickRegion& region) {
+    std::vector<double> out(region.count());
+    const size_t nx = region.i1 - region.i0 + 1;
+    const size_t ny = region.j1 - region.j0 + 1;
+    for_each_brick(filename, region, [&](const BrickRegion& brick, const std::vector<double>& values) {
+        const size_t bx = brick.i1 - brick.i0 + 1;
+        const size_t by = brick.j1 - brick.j0 + 1;
+        for (size_t k = std::max(brick.k0, region.k0); k <= std::min(brick.k1, region.k1); ++k)
+            for (size_t j = std::max(brick.j0, region.j0); j <= std::min(brick.j1, region.j1); ++j)
+                for (size_t i = std::max(brick.i0, region.i0); i <= std::min(brick.i1, region.i1); ++i)
+                    out[(i - region.i0) + nx * ((j - region.j0) + ny * (k - region.k0))]
+                        = values[(i - brick.i0) + bx * ((j - brick.j0) + by * (k - brick.k0))];
+    });
+    return out;
+}
+
+void BrickSnapshot::read(const std::string& filename, Solution& solution) {
+    const BrickHeader header = read_header(filename);
+    if ((header.nx + 1) * (header.ny + 1) * (header.nz + 1) != solution.size()) {
+        throw std::runtime_error(filename + ": brick snapshot size does not match the solution");
+    }
+    const BrickRegion all = {0, header.nx, 0, header.ny, 0, header.nz};
+    for_each_brick(filename, all, [&](const BrickRegion& brick, const std::vector<double>& values) {
+        scatter(values, brick, solution);
+    });
+}
@@ -0,0 +1,224 @@
+/**
+ * @file brick_snapshot.hpp
+ * @brief Chunked, compressed snapshot container with a random-access index
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ *
+ * The grid is split into bricks of brick_size^3 points, each compressed on
+ * its own (byte shuffle then zlib), so a reader only decompresses the
+ * bricks intersecting the sub-volume it asks for:
+ *
+ *   offset 0                 BrickHeader (magic "HEATBRK", shape, brick size, ...)
+ *   offset sizeof(header)    BrickIndexEntry per brick (offset, size, codec)
+ *   index_offset + index     compressed bricks, in brick order (i fastest)
+ *
+ * Inside a brick, values are float64 in x-fastest order over the grid
+ * points (i, j, k) as read through Solution::operator().
+ *
+ * With an error bound, bricks use a lossy codec in the style of SZ: each
+ * value is predicted from its already reconstructed neighbours (3D Lorenzo
+ * predictor), the residual is quantized in steps of twice the bound and
+ * the integer codes are shuffled and deflated. Values the quantizer cannot
+ * represent within the bound are stored exactly.
+ */
+
+#ifndef BRICK_SNAPSHOT_HPP
+#define BRICK_SNAPSHOT_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "parameters.hpp"
+#include "solution.hpp"
+#include "thread_pool.hpp"
+
+/**
+ * @struct BrickHeader
+ * @brief Fixed header at the beginning of a brick container
+ */
+struct BrickHeader {
+    static constexpr char MAGIC[8] = {'H', 'E', 'A', 'T', 'B', 'R', 'K', '\0'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t ENDIAN_CHECK = 0x01020304;
+
+    char magic[8];              ///< "HEATBRK"
+    uint32_t version;           ///< Format version
+    uint32_t endian_check;      ///< ENDIAN_CHECK in the byte order of the writer
+    uint64_t nx, ny, nz;        ///< Subdivisions in each direction
+    uint64_t brick_size;        ///< Points per brick edge (last bricks may be smaller)
+    uint64_t bricks;            ///< Number of bricks (and of index entries)
+    double dx, dy, dz;          ///< Grid spacing
+    double time;                ///< Simulated time
+    uint64_t iteration;         ///< Iterations completed
+    uint64_t index_offset;      ///< Offset of the index in the file
+};
+
+/**
+ * @struct BrickIndexEntry
+ * @brief Location and codec of one brick
+ */
+struct BrickIndexEntry {
+    static constexpr uint32_t CODEC_RAW = 0;            ///< Stored as is (incompressible brick)
+    static constexpr uint32_t CODEC_SHUFFLE_ZLIB = 1;   ///< Byte shuffle then zlib
+    static constexpr uint32_t CODEC_LORENZO_ZLIB = 2;   ///< Lorenzo prediction, quantization, shuffle then zlib (lossy)
+
+    uint64_t offset;            ///< Offset of the brick in the file
+    uint32_t bytes;             ///< Stored size (brick_size is limited so that a raw brick fits)
+    uint32_t codec;             ///< CODEC_RAW, CODEC_SHUFFLE_ZLIB or CODEC_LORENZO_ZLIB
+};
+
+/**
+ * @struct BrickOptions
+ * @brief Brick size and codec of a brick container
+ */
+struct BrickOptions {
+    size_t brick_size = 32;     ///< Points per brick edge
+    int level = 1;              ///< zlib compression level (1 fastest, 9 smallest)
+    double abs_error = 0.0;     ///< Absolute error bound (0: lossless)
+    double rel_error = 0.0;     ///< Error bound relative to the value range of the grid (0: lossless)
+
+    /**
+     * @brief Reads brick_size, brick_level, lossy_abs_error and lossy_rel_error
+     * @throw std::runtime_error if a brick of brick_size could exceed the 4 GiB of an index entry
+     */
+    static BrickOptions from_parameters(const Parameters& params);
+};
+
+/**
+ * @struct BrickStats
+ * @brief Sizes of written brick containers
+ */
+struct BrickStats {
+    uint64_t raw_bytes = 0;     ///< Size of the values in float64
+    uint64_t stored_bytes = 0;  ///< Size of the files (header and index included)
+    uint64_t bricks = 0;        ///< Number of bricks
+    double error_bound = 0.0;   ///< Absolute error bound used (0: lossless)
+    double max_error = 0.0;     ///< Largest absolute error of the stored values
+
+    double ratio() const { return stored_bytes > 0 ? static_cast<double>(raw_bytes) / stored_bytes : 0.0; }
+
+    BrickStats& operator+=(const BrickStats& other) {
+        raw_bytes += other.raw_bytes;
+        stored_bytes += other.stored_bytes;
+        bricks += other.bricks;
+        error_bound = std::max(error_bound, other.error_bound);
+        max_error = std::max(max_error, other.max_error);
+        return *this;
+    }
+};
+
+/**
+ * @struct BrickRegion
+ * @brief Inclusive box of grid points [i0, i1] x [j0, j1] x [k0, k1]
+ */
+struct BrickRegion {
+    size_t i0, i1, j0, j1, k0, k1;
+
+    size_t count() const { return (i1 - i0 + 1) * (j1 - j0 + 1) * (k1 - k0 + 1); }
+};
+
+/**
+ * @struct BrickGrid
+ * @brief Decomposition of the grid points in bricks, numbered i fastest
+ */
+struct BrickGrid {
+    size_t points[3];   ///< Points par direction (n + 1)
+    size_t edge;        ///< Points par arête de brique
+    size_t counts[3];   ///< Briques par direction
+
+    BrickGrid(uint64_t nx, uint64_t ny, uint64_t nz, size_t edge) : edge(edge) {
+        points[0] = nx + 1;
+        points[1] = ny + 1;
+        points[2] = nz + 1;
+        for (int d = 0; d < 3; ++d) counts[d] = (points[d] + edge - 1) / edge;
+    }
+
+    size_t bricks() const { return counts[0] * counts[1] * counts[2]; }
+
+    /**
+     * @brief Largest stored size of a brick: the first (full) brick kept raw, since no codec stores more
+     */
+    uint64_t max_brick_bytes() const { return static_cast<uint64_t>(region(0).count()) * sizeof(double); }
+
+    BrickRegion region(size_t brick) const {
+        const size_t bi = brick % counts[0];
+        const size_t bj = (brick / counts[0]) % counts[1];
+        const size_t bk = brick / (counts[0] * counts[1]);
+        return {bi * edge, std::min((bi + 1) * edge, points[0]) - 1,
+                bj * edge, std::min((bj + 1) * edge, points[1]) - 1,
+                bk * edge, std::min((bk + 1) * edge, points[2]) - 1};
+    }
+};
+
+/**
+ * @class BrickSnapshot
+ * @brief Writes and reads brick containers
+ */
+class BrickSnapshot {
+public:
+    /**
+     * @brief Compresses the bricks in parallel and writes the container
+     * @param filename Path of the file
+     * @param solution Grid values
+     * @param params Parameters of the grid
+     * @param time Simulated time
+     * @param iteration Iterations completed
+     * @param pool Threads compressing the bricks
+     * @param options Brick size, zlib level and error bound
+     * @return Raw and stored sizes, error bound and largest error
+     * @throw std::runtime_error if the file cannot be written
+     *
+     * The file is written with the backend selected by the io_* parameters (see FileWriter).
+     */
+    static BrickStats write(const std::string& filename, const Solution& solution, const Parameters& params,
+                            double time, uint64_t iteration, ThreadPool& pool,
+                            const BrickOptions& options = BrickOptions());
+
+    /**
+     * @brief Reads and validates the header of a container
+     * @throw std::runtime_error if the file is not a valid container
+     */
+    static BrickHeader read_header(const std::string& filename);
+
+    /**
+     * @brief Reads a sub-volume, decompressing only the bricks it intersects
+     * @param filename Path of the file
+     * @param region Box of grid points to read, inside the grid
+     * @return region.count() values, x fastest
+     * @throw std::runtime_error if the region is outside the grid or a brick is corrupted
+     */
+    static std::vector<double> read_region(const std::string& filename, const BrickRegion& region);
+
+    /**
+     * @brief Copies the points of a region of the grid, x fastest
+     */
+    static void gather(const Solution& solution, const BrickRegion& region, std::vector<double>& values);
+
+    /**
+     * @brief Inverse of gather
+     */
+    static void scatter(const std::vector<double>& values, const BrickRegion& region, Solution& solution);
+
+    /**
+     * @brief Lossless encoding of gathered values: shuffle and zlib, or raw when it does not shrink
+     * @return CODEC_SHUFFLE_ZLIB or CODEC_RAW
+     */
+    static uint32_t encode(const std::vector<double>& values, int level, std::vector<uint8_t>& out);
+
+    /**
+     * @brief Decodes a stored brick of any codec
+     * @throw std::runtime_error if the brick is corrupted
+     */
+    static void decode(const std::vector<uint8_t>& stored, uint32_t codec, const BrickRegion& region,
+                       std::vector<double>& values);
+
+    /**
+     * @brief Reads the whole grid into a Solution
+     * @param filename Path of the file
+     * @param solution Destination, whose grid must match the container
+     */
+    static void read(const std::string& filename, Solution& solution);
+};
+
+#endif
@@ -0,0 +1,64 @@
+/**
+ * @file checkpoint.cpp
+ * @brief Implementation of the Checkpoint class methods
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ */
+
+#include "checkpoint.hpp"
+#include "snapshot.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+// Force l'écriture sur disque d'un fichier ou d'un répertoire
+void sync_path(const std::string& path, bool required) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        if (required) throw std::runtime_error("Impossible to open the file " + path);
+        return;
+    }
+    const int result = ::fsync(fd);
+    ::close(fd);
+    if (result != 0 && required) {
+        throw std::runtime_error("Impossible to sync the file " + path + ": " + std::strerror(errno));
+    }
+}
+
+}  // namespace
+
+void Checkpoint::write(const std::string& filename, const Solution& solution, const Parameters& params,
+                       double time, uint64_t iteration) {
+    const std::string temporary = filename + ".tmp";
+    Snapshot::write(temporary, solution, params, time, iteration, sizeof(double));
+    commit(temporary, filename);
+}
+
+/**
+ * @brief Implementation of the atomic write
+ *
+ * The temporary file is synced before the rename and the directory after
+ * it, so the rename never exposes a file whose data is not on disk yet.
+ */
+void Checkpoint::commit(const std::string& temporary, const std::string& filename) {
+    sync_path(temporary, true);
+    if (std::rename(temporary.c_str(), filename.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        throw std::runtime_error("Impossible to rename " + temporary + " to " + filename + ": " + std::strerror(errno));
+    }
+    const size_t slash = filename.find_last_of('/');
+    sync_path(slash == std::string::npos ? "." : (slash == 0 ? "/" : filename.substr(0, slash)), false);
+}
+
+CheckpointState Checkpoint::load(const std::string& filename, Parameters& params) {
+    const SnapshotHeader header = Snapshot::read_header(filename);
+    if (header.params_hash != Snapshot::params_hash(params)) {
+        throw std::runtime_error(filename + ": checkpoint written with other parameters (grid or time step differ)");
+    }
+    return CheckpointState{Snapshot::map(filename, params), header.time, header.iteration};
+}
@@ -0,0 +1,65 @@
+/**
+ * @file checkpoint.hpp
+ * @brief Atomic checkpoints of the solver state and their reload by mmap
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ *
+ * A checkpoint is a float64 snapshot (see snapshot.hpp) holding U_current,
+ * the simulated time, the iterations completed and the parameters hash. It
+ * is written to <file>.tmp, flushed to disk and renamed over <file>, so a
+ * crash leaves either the previous checkpoint or the new one, never a mix.
+ */
+
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <cstdint>
+#include <string>
+#include "parameters.hpp"
+#include "solution.hpp"
+
+/**
+ * @struct CheckpointState
+ * @brief Solver state read back from a checkpoint
+ */
+struct CheckpointState {
+    Solution solution;          ///< View on the mapped values (copy-on-write)
+    double time;                ///< Simulated time
+    uint64_t iteration;         ///< Iterations completed
+};
+
+/**
+ * @class Checkpoint
+ * @brief Writes and reloads checkpoints
+ */
+class Checkpoint {
+public:
+    /**
+     * @brief Writes a checkpoint atomically
+     * @param filename Path of the checkpoint, replaced only once the new one is on disk
+     * @param solution Grid values
+     * @param params Parameters of the run
+     * @param time Simulated time
+     * @param iteration Iterations completed
+     * @throw std::runtime_error if the file cannot be written or renamed
+     */
+    static void write(const std::string& filename, const Solution& solution, const Parameters& params,
+                      double time, uint64_t iteration);
+
+    /**
+     * @brief Syncs a fully written temporary file and renames it over filename, then syncs the directory
+     * @throw std::runtime_error if the file cannot be synced or renamed
+     */
+    static void commit(const std::string& temporary, const std::string& filename);
+
+    /**
+     * @brief Maps a checkpoint, without parsing or copying the values
+     * @param filename Path of the checkpoint
+     * @param params Parameters of the run to resume
+     * @return The state, whose solution stays mapped while it or a copy of it exists
+     * @throw std::runtime_error if the checkpoint was written with other parameters
+     */
+    static CheckpointState load(const std::string& filename, Parameters& params);
+};
+
+#endif
@@ -0,0 +1,44 @@
+/**
+ * @file codec.cpp
+ * @brief Implementation of the Codec class methods
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ */
+
+#include "codec.hpp"
+#include <zlib.h>
+
+constexpr uint32_t Codec::OUTLIER;
+constexpr long long Codec::MAX_QUANTUM;
+
+// Regroupe l'octet b de chaque valeur : les exposants voisins deviennent des suites compressibles
+void Codec::shuffle(const void* values, size_t count, size_t width, uint8_t* out) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(values);
+    for (size_t e = 0; e < count; ++e) {
+        for (size_t b = 0; b < width; ++b) {
+            out[b * count + e] = bytes[e * width + b];
+        }
+    }
+}
+
+void Codec::unshuffle(const uint8_t* in, size_t count, size_t width, void* values) {
+    uint8_t* bytes = static_cast<uint8_t*>(values);
+    for (size_t e = 0; e < count; ++e) {
+        for (size_t b = 0; b < width; ++b) {
+            bytes[e * width + b] = in[b * count + e];
+        }
+    }
+}
+
+bool Codec::deflate(const uint8_t* in, size_t bytes, int level, std::vector<uint8_t>& out, size_t prefix) {
+    uLongf size = compressBound(bytes);
+    out.resize(prefix + size);
+    if (compress2(out.data() + prefix, &size, in, bytes, level) != Z_OK) return false;
+    out.resize(prefix + size);
+    return true;
+}
+
+bool Codec::inflate(const uint8_t* in, size_t bytes, uint8_t* out, size_t expected) {
+    uLongf size = expected;
+    return uncompress(out, &size, in, bytes) == Z_OK && size == expected;
+}
@@ -0,0 +1,61 @@
+/**
+ * @file codec.hpp
+ * @brief Byte shuffle, zlib and quantization helpers shared by the compressed outputs
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ */
+
+#ifndef CODEC_HPP
+#define CODEC_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class Codec
+ * @brief Building blocks of the brick and time-series codecs
+ */
+class Codec {
+public:
+    static constexpr uint32_t OUTLIER = 0xFFFFFFFFu;      ///< Code of a value stored exactly
+    static constexpr long long MAX_QUANTUM = 1LL << 30;   ///< Largest quantized residual (exclusive)
+
+    /**
+     * @brief Groups byte b of every element together (all bytes 0, then all bytes 1, ...)
+     * @param values count elements of width bytes
+     * @param out count * width bytes
+     */
+    static void shuffle(const void* values, size_t count, size_t width, uint8_t* out);
+
+    /**
+     * @brief Inverse of shuffle
+     */
+    static void unshuffle(const uint8_t* in, size_t count, size_t width, void* values);
+
+    /**
+     * @brief Compresses bytes with zlib into out, after prefix bytes left for the caller
+     * @return false if zlib fails
+     */
+    static bool deflate(const uint8_t* in, size_t bytes, int level, std::vector<uint8_t>& out, size_t prefix = 0);
+
+    /**
+     * @brief Decompresses exactly expected bytes
+     * @return false if the data is corrupted or its size differs
+     */
+    static bool inflate(const uint8_t* in, size_t bytes, uint8_t* out, size_t expected);
+
+    /**
+     * @brief Maps a signed quantum to an unsigned code (0, -1, 1, -2, ... -> 0, 1, 2, 3, ...)
+     */
+    static uint32_t zigzag(long long quantum) {
+        // Décalage sur la valeur non signée : quantum << 1 est indéfini pour quantum < 0
+        return static_cast<uint32_t>((static_cast<uint64_t>(quantum) << 1) ^ static_cast<uint64_t>(quantum >> 63));
+    }
+
+    static long long unzigzag(uint32_t code) {
+        return static_cast<long long>(code >> 1) ^ -static_cast<long long>(code & 1);
+    }
+};
+
+#endif
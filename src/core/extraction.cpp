@@ -0,0 +1,342 @@
+/**
+ * @file extraction.cpp
+ * @brief Implementation of the Extractor and ExtractionReader class methods
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ */
+
+#include "extraction.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+constexpr char ExtractionHeader::MAGIC[8];
+
+namespace {
+
+std::vector<std::string> split(const std::string& text, char separator) {
+    std::vector<std::string> parts;
+    std::istringstream stream(text);
+    std::string part;
+    while (std::getline(stream, part, separator)) {
+        if (!part.empty()) parts.push_back(part);
+    }
+    return parts;
+}
+
+int parse_axis(const std::string& text, const std::string& spec) {
+    if (text == "x") return 0;
+    if (text == "y") return 1;
+    if (text == "z") return 2;
+    throw std::runtime_error("Invalid axis in extract '" + spec + "' (x, y or z)");
+}
+
+std::vector<double> parse_numbers(const std::string& text, size_t count, const std::string& spec) {
+    std::vector<double> numbers;
+    for (const std::string& part : split(text, ',')) {
+        try {
+            numbers.push_back(std::stod(part));
+        } catch (const std::exception&) {
+            throw std::runtime_error("Invalid number in extract '" + spec + "'");
+        }
+    }
+    if (numbers.size() != count) {
+        throw std::runtime_error("Extract '" + spec + "' needs " + std::to_string(count) + " coordinates");
+    }
+    return numbers;
+}
+
+}  // namespace
+
+Extractor::Extractor(const std::string& filename, const Parameters& params, size_t group_size)
+    : group_size(std::max<size_t>(1, group_size))
+    , m_steps(0)
+    , m_bytes(0)
+{
+    for (const ExtractionColumn& column : parse_probes(params.getString("probes", ""))) {
+        add(column, params);
+    }
+    // name:axis=position
+    for (const std::string& spec : split(params.getString("slices", ""), ';')) {
+        const size_t colon = spec.find(':');
+        const size_t equal = spec.find('=');
+        if (colon == std::string::npos || equal == std::string::npos || equal < colon) {
+            throw std::runtime_error("Invalid slice '" + spec + "' (name:axis=position)");
+        }
+        ExtractionColumn column{};
+        column.kind = ExtractionColumn::SLICE;
+        column.axis = parse_axis(spec.substr(colon + 1, equal - colon - 1), spec);
+        column.position[column.axis] = parse_numbers(spec.substr(equal + 1), 1, spec)[0];
+        std::strncpy(column.name, spec.substr(0, colon).c_str(), sizeof(column.name) - 1);
+        add(column, params);
+    }
+    // name:axis@a,b (a, b : les deux autres coordonnées dans l'ordre x, y, z)
+    for (const std::string& spec : split(params.getString("lines", ""), ';')) {
+        const size_t colon = spec.find(':');
+        const size_t at = spec.find('@');
+        if (colon == std::string::npos || at == std::string::npos || at < colon) {
+            throw std::runtime_error("Invalid line '" + spec + "' (name:axis@a,b)");
+        }
+        ExtractionColumn column{};
+        column.kind = ExtractionColumn::LINE;
+        column.axis = parse_axis(spec.substr(colon + 1, at - colon - 1), spec);
+        const std::vector<double> others = parse_numbers(spec.substr(at + 1), 2, spec);
+        for (int d = 0, n = 0; d < 3; ++d) {
+            if (d != static_cast<int>(column.axis)) column.position[d] = others[n++];
+        }
+        std::strncpy(column.name, spec.substr(0, colon).c_str(), sizeof(column.name) - 1);
+        add(column, params);
+    }
+    if (columns.empty()) {
+        throw std::runtime_error("No extract defined (probes, slices or lines)");
+    }
+
+    buffers.resize(columns.size());
+    file = FileWriter::open(filename, IoOptions::from_parameters(params));
+    ExtractionHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, ExtractionHeader::MAGIC, sizeof(header.magic));
+    header.version = ExtractionHeader::VERSION;
+    header.endian_check = ExtractionHeader::ENDIAN_CHECK;
+    header.columns = columns.size();
+    header.dx = params.getDx();
+    header.dy = params.getDy();
+    header.dz = params.getDz();
+    file->write(&header, sizeof(header));
+    file->write(columns.data(), columns.size() * sizeof(ExtractionColumn));
+    m_bytes = sizeof(header) + columns.size() * sizeof(ExtractionColumn);
+}
+
+std::vector<ExtractionColumn> Extractor::parse_probes(const std::string& list) {
+    // name:x,y,z
+    std::vector<ExtractionColumn> probes;
+    for (const std::string& spec : split(list, ';')) {
+        const size_t colon = spec.find(':');
+        if (colon == std::string::npos) {
+            throw std::runtime_error("Invalid probe '" + spec + "' (name:x,y,z)");
+        }
+        ExtractionColumn column{};
+        column.kind = ExtractionColumn::PROBE;
+        const std::vector<double> point = parse_numbers(spec.substr(colon + 1), 3, spec);
+        std::copy(point.begin(), point.end(), column.position);
+        std::strncpy(column.name, spec.substr(0, colon).c_str(), sizeof(column.name) - 1);
+        probes.push_back(column);
+    }
+    return probes;
+}
+
+Extractor::~Extractor() {
+    try {
+        close();
+    } catch (const std::exception& error) {
+        std::cerr << "Extraction: " << error.what() << std::endl;
+    }
+}
+
+/**
+ * @brief Implementation of the sampling plan of an extract
+ *
+ * Along each axis a coordinate c gives the lower grid index floor(c / d)
+ * (the last cell for c at the upper bound) and the weight of the upper one.
+ * Grid coordinates of slices and lines fall exactly on points (weight 0).
+ */
+void Extractor::add(ExtractionColumn column, const Parameters& params) {
+    const size_t n[3] = {params.getNx(), params.getNy(), params.getNz()};
+    const double d[3] = {params.getDx(), params.getDy(), params.getDz()};
+    const std::string name = column.name;
+    if (name.empty()) {
+        throw std::runtime_error("Extract without a name");
+    }
+    for (const ExtractionColumn& other : columns) {
+        if (name == other.name) throw std::runtime_error("Duplicate extract name " + name);
+    }
+
+    auto locate = [&](int axis, double coordinate, size_t& index, double& weight) {
+        const double f = coordinate / d[axis];
+        if (!(f >= -1e-9 && f <= n[axis] + 1e-9)) {
+            throw std::runtime_error("Extract " + name + " is outside the domain");
+        }
+        index = std::min(static_cast<size_t>(std::max(0.0, std::floor(f))), n[axis] - 1);
+        weight = std::min(1.0, std::max(0.0, f - static_cast<double>(index)));
+    };
+
+    // Axes parcourus point par point (x le plus rapide) et axes interpolés
+    std::vector<int> walked;
+    if (column.kind == ExtractionColumn::SLICE) {
+        for (int a = 0; a < 3; ++a) if (a != static_cast<int>(column.axis)) walked.push_back(a);
+    } else if (column.kind == ExtractionColumn::LINE) {
+        walked.push_back(static_cast<int>(column.axis));
+    }
+    column.dims[0] = walked.size() > 0 ? n[walked[0]] + 1 : 1;
+    column.dims[1] = walked.size() > 1 ? n[walked[1]] + 1 : 1;
+    column.width = column.dims[0] * column.dims[1];
+
+    Sample fixed{};
+    size_t* index[3] = {&fixed.i, &fixed.j, &fixed.k};
+    double* weight[3] = {&fixed.tx, &fixed.ty, &fixed.tz};
+    for (int a = 0; a < 3; ++a) {
+        if (std::find(walked.begin(), walked.end(), a) == walked.end()) {
+            locate(a, column.position[a], *index[a], *weight[a]);
+        }
+    }
+
+    std::vector<Sample> points;
+    points.reserve(column.width);
+    for (size_t v = 0; v < column.dims[1]; ++v) {
+        for (size_t u = 0; u < column.dims[0]; ++u) {
+            Sample sample = fixed;
+            size_t* sample_index[3] = {&sample.i, &sample.j, &sample.k};
+            double* sample_weight[3] = {&sample.tx, &sample.ty, &sample.tz};
+            const size_t walk[2] = {u, v};
+            for (size_t w = 0; w < walked.size(); ++w) {
+                // Le dernier point est pris comme poids 1 sur la dernière maille
+                const int a = walked[w];
+                *sample_index[a] = std::min(walk[w], n[a] - 1);
+                *sample_weight[a] = walk[w] == n[a] ? 1.0 : 0.0;
+            }
+            points.push_back(sample);
+        }
+    }
+    columns.push_back(column);
+    samples.push_back(std::move(points));
+}
+
+void Extractor::sample(const Solution& solution, double time, uint64_t iteration) {
+    for (size_t c = 0; c < columns.size(); ++c) {
+        std::vector<double>& buffer = buffers[c];
+        for (const Sample& s : samples[c]) {
+            const double x0 = 1.0 - s.tx, y0 = 1.0 - s.ty, z0 = 1.0 - s.tz;
+            const double value =
+                z0 * (y0 * (x0 * solution(s.i, s.j, s.k)         + s.tx * solution(s.i + 1, s.j, s.k))
+                    + s.ty * (x0 * solution(s.i, s.j + 1, s.k)     + s.tx * solution(s.i + 1, s.j + 1, s.k)))
+              + s.tz * (y0 * (x0 * solution(s.i, s.j, s.k + 1)     + s.tx * solution(s.i + 1, s.j, s.k + 1))
+                    + s.ty * (x0 * solution(s.i, s.j + 1, s.k + 1) + s.tx * solution(s.i + 1, s.j + 1, s.k + 1)));
+            buffer.push_back(value);
+        }
+    }
+    times.push_back(time);
+    iterations.push_back(iteration);
+    ++m_steps;
+    if (times.size() == group_size) {
+        flush();
+    }
+}
+
+void Extractor::flush() {
+    if (times.empty()) return;
+    ExtractionGroup group;
+    group.steps = times.size();
+    group.bytes = times.size() * (sizeof(double) + sizeof(uint64_t));
+    for (const std::vector<double>& buffer : buffers) group.bytes += buffer.size() * sizeof(double);
+
+    file->write(&group, sizeof(group));
+    file->write(times.data(), times.size() * sizeof(double));
+    file->write(iterations.data(), iterations.size() * sizeof(uint64_t));
+    for (std::vector<double>& buffer : buffers) {
+        file->write(buffer.data(), buffer.size() * sizeof(double));
+        buffer.clear();
+    }
+    m_bytes += sizeof(group) + group.bytes;
+    times.clear();
+    iterations.clear();
+}
+
+void Extractor::close() {
+    if (file) {
+        flush();
+        std::unique_ptr<FileWriter> closing = std::move(file);
+        closing->close();
+    }
+}
+
+ExtractionReader::ExtractionReader(const std::string& filename)
+    : filename(filename)
+    , file(filename, std::ios::binary)
+{
+    if (!file.is_open()) {
+        throw std::runtime_error("Impossible to open the file " + filename);
+    }
+    ExtractionHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, ExtractionHeader::MAGIC, sizeof(header.magic)) != 0) {
+        throw std::runtime_error(filename + " is not an extraction file");
+    }
+    if (header.version != ExtractionHeader::VERSION) {
+        throw std::runtime_error(filename + ": unsupported extraction version " + std::to_string(header.version));
+    }
+    if (header.endian_check != ExtractionHeader::ENDIAN_CHECK) {
+        throw std::runtime_error(filename + ": extraction file written with another byte order");
+    }
+    columns.resize(header.columns);
+    if (!file.read(reinterpret_cast<char*>(columns.data()), columns.size() * sizeof(ExtractionColumn))) {
+        throw std::runtime_error(filename + ": truncated extraction file");
+    }
+
+    uint64_t step_bytes = sizeof(double) + sizeof(uint64_t);
+    for (const ExtractionColumn& column : columns) step_bytes += column.width * sizeof(double);
+
+    file.seekg(0, std::ios::end);
+    const uint64_t size = static_cast<uint64_t>(file.tellg());
+    uint64_t offset = sizeof(header) + columns.size() * sizeof(ExtractionColumn);
+    ExtractionGroup group;
+    while (offset + sizeof(group) <= size) {
+        file.seekg(offset);
+        file.read(reinterpret_cast<char*>(&group), sizeof(group));
+        if (!file || group.steps == 0 || group.bytes != group.steps * step_bytes
+            || offset + sizeof(group) + group.bytes > size) {
+            break;
+        }
+        groups.push_back(Group{group.steps, offset + sizeof(group)});
+        offset += sizeof(group) + group.bytes;
+    }
+    file.clear();
+}
+
+void ExtractionReader::read_at(uint64_t offset, void* data, size_t bytes) {
+    file.seekg(offset);
+    if (!file.read(static_cast<char*>(data), bytes)) {
+        throw std::runtime_error("Error while reading the file " + filename);
+    }
+}
+
+std::vector<double> ExtractionReader::times() {
+    std::vector<double> values;
+    for (const Group& group : groups) {
+        const size_t first = values.size();
+        values.resize(first + group.steps);
+        read_at(group.offset, values.data() + first, group.steps * sizeof(double));
+    }
+    return values;
+}
+
+std::vector<uint64_t> ExtractionReader::iterations() {
+    std::vector<uint64_t> values;
+    for (const Group& group : groups) {
+        const size_t first = values.size();
+        values.resize(first + group.steps);
+        read_at(group.offset + group.steps * sizeof(double), values.data() + first, group.steps * sizeof(uint64_t));
+    }
+    return values;
+}
+
+std::vector<double> ExtractionReader::column(const std::string& name) {
+    size_t c = 0;
+    while (c < columns.size() && name != columns[c].name) ++c;
+    if (c == columns.size()) {
+        throw std::runtime_error(filename + ": no extract named " + name);
+    }
+
+    std::vector<double> values;
+    for (const Group& group : groups) {
+        // Les colonnes d'un groupe suivent les temps et les itérations
+        uint64_t offset = group.offset + group.steps * (sizeof(double) + sizeof(uint64_t));
+        for (size_t before = 0; before < c; ++before) offset += group.steps * columns[before].width * sizeof(double);
+        const size_t first = values.size();
+        values.resize(first + group.steps * columns[c].width);
+        read_at(offset, values.data() + first, group.steps * columns[c].width * sizeof(double));
+    }
+    return values;
+}
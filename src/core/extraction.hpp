@@ -0,0 +1,188 @@
+/**
+ * @file extraction.hpp
+ * @brief In-situ extraction of probes, slices and lines into a columnar time series
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ *
+ * Extracts are declared in the parameters, in physical coordinates:
+ *   probes=hot:0.5,0.5,0.5;corner:0.1,0.1,0.1     points, trilinear interpolation
+ *   slices=mid:z=0.5;side:x=0.25                  planes normal to an axis
+ *   lines=centre:x@0.5,0.5                        lines along an axis, at (y, z) = (0.5, 0.5)
+ *
+ * Slices and lines keep the grid points along their own axes and are
+ * interpolated linearly across the others. The interpolation weights are
+ * computed once, so a sample only reads the 8 corners of each point.
+ *
+ * The file is columnar: samples are buffered in groups of up to group_size
+ * steps, and each group is written column after column, so a reader loads
+ * one extract over time without touching the others:
+ *
+ *   offset 0     ExtractionHeader (magic "HEATEXT", number of columns)
+ *   then         ExtractionColumn per extract (name, kind, geometry, width)
+ *   then         groups: ExtractionGroup, time[steps], iteration[steps],
+ *                then for each column its steps * width values (float64)
+ */
+
+#ifndef EXTRACTION_HPP
+#define EXTRACTION_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "file_writer.hpp"
+#include "parameters.hpp"
+#include "solution.hpp"
+
+/**
+ * @struct ExtractionHeader
+ * @brief Fixed header at the beginning of an extraction file
+ */
+struct ExtractionHeader {
+    static constexpr char MAGIC[8] = {'H', 'E', 'A', 'T', 'E', 'X', 'T', '\0'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t ENDIAN_CHECK = 0x01020304;
+
+    char magic[8];              ///< "HEATEXT"
+    uint32_t version;           ///< Format version
+    uint32_t endian_check;      ///< ENDIAN_CHECK in the byte order of the writer
+    uint64_t columns;           ///< Number of extracts
+    double dx, dy, dz;          ///< Grid spacing
+};
+
+/**
+ * @struct ExtractionColumn
+ * @brief Description of one extract
+ */
+struct ExtractionColumn {
+    static constexpr uint32_t PROBE = 0;
+    static constexpr uint32_t SLICE = 1;
+    static constexpr uint32_t LINE = 2;
+
+    char name[48];              ///< Name given in the parameters
+    uint32_t kind;              ///< PROBE, SLICE or LINE
+    uint32_t axis;              ///< SLICE: normal axis, LINE: axis of the line (0 = x, 1 = y, 2 = z)
+    double position[3];         ///< PROBE: point; SLICE: position[axis]; LINE: the two other coordinates
+    uint64_t dims[2];           ///< Values per step along each direction (x fastest): 1x1, plane or n x 1
+    uint64_t width;             ///< Values per step (dims[0] * dims[1])
+};
+
+/**
+ * @struct ExtractionGroup
+ * @brief Header of a group of steps
+ */
+struct ExtractionGroup {
+    uint64_t steps;             ///< Steps in the group
+    uint64_t bytes;             ///< Size of the group after this header
+};
+
+/**
+ * @class Extractor
+ * @brief Samples the extracts of the parameters and appends them to an extraction file
+ */
+class Extractor {
+private:
+    // Point d'échantillonnage : coin inférieur et poids de l'interpolation trilinéaire
+    struct Sample {
+        size_t i, j, k;
+        double tx, ty, tz;
+    };
+
+    std::vector<ExtractionColumn> columns;
+    std::vector<std::vector<Sample>> samples;   // Points de chaque colonne
+    std::unique_ptr<FileWriter> file;
+    size_t group_size;
+    std::vector<double> times;
+    std::vector<uint64_t> iterations;
+    std::vector<std::vector<double>> buffers;   // Valeurs du groupe en cours, par colonne
+    uint64_t m_steps;
+    uint64_t m_bytes;
+
+public:
+    /**
+     * @brief Parses the probes, slices and lines parameters and creates the file
+     * @param filename Path of the extraction file
+     * @param params Parameters with the extracts, the grid and the io_* options
+     * @param group_size Steps buffered before a group is written
+     * @throw std::runtime_error for an invalid or out-of-domain extract
+     */
+    Extractor(const std::string& filename, const Parameters& params, size_t group_size = 64);
+
+    ~Extractor();
+
+    /**
+     * @brief Parses a probes list ("name:x,y,z;...") into PROBE columns (name and position)
+     * @throw std::runtime_error for a probe without a name or three coordinates
+     */
+    static std::vector<ExtractionColumn> parse_probes(const std::string& list);
+
+    Extractor(const Extractor&) = delete;
+    Extractor& operator=(const Extractor&) = delete;
+
+    /**
+     * @brief Samples every extract for one step
+     */
+    void sample(const Solution& solution, double time, uint64_t iteration);
+
+    /**
+     * @brief Writes the buffered steps and closes the file
+     */
+    void close();
+
+    const std::vector<ExtractionColumn>& extracts() const { return columns; }
+    uint64_t steps() const { return m_steps; }
+    uint64_t bytes() const { return m_bytes; }
+
+private:
+    void add(ExtractionColumn column, const Parameters& params);
+    void flush();
+};
+
+/**
+ * @class ExtractionReader
+ * @brief Loads columns of an extraction file
+ */
+class ExtractionReader {
+public:
+    /**
+     * @brief Opens a file and indexes its groups
+     * @throw std::runtime_error if the file is not a valid extraction file
+     *
+     * A truncated last group (interrupted run) is ignored.
+     */
+    explicit ExtractionReader(const std::string& filename);
+
+    const std::vector<ExtractionColumn>& extracts() const { return columns; }
+
+    /**
+     * @brief Simulated time of every step
+     */
+    std::vector<double> times();
+
+    /**
+     * @brief Iterations of every step
+     */
+    std::vector<uint64_t> iterations();
+
+    /**
+     * @brief Values of one extract over all steps (steps * width, step by step)
+     * @throw std::runtime_error if there is no extract of that name
+     */
+    std::vector<double> column(const std::string& name);
+
+private:
+    struct Group {
+        uint64_t steps;
+        uint64_t offset;                // Position des temps du groupe
+    };
+
+    std::string filename;
+    std::ifstream file;
+    std::vector<ExtractionColumn> columns;
+    std::vector<Group> groups;
+
+    void read_at(uint64_t offset, void* data, size_t bytes);
+};
+
+#endif
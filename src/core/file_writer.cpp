@@ -0,0 +1,515 @@
+/**
+ * @file file_writer.cpp
+ * @brief Implementation of the FileWriter backends
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ */
+
+#include "file_writer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define HEAT_HAVE_IO_URING 1
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace {
+
+constexpr size_t ALIGNMENT = 4096;  // Alignement requis par O_DIRECT (taille de page)
+
+size_t round_up(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+std::string system_error(const std::string& what, const std::string& filename) {
+    return what + " " + filename + ": " + std::strerror(errno);
+}
+
+/**
+ * @brief Page-aligned heap buffer, as required by O_DIRECT
+ */
+struct AlignedBuffer {
+    explicit AlignedBuffer(size_t size) : data(nullptr), size(size) {
+        if (posix_memalign(reinterpret_cast<void**>(&data), ALIGNMENT, size) != 0) {
+            throw std::bad_alloc();
+        }
+    }
+    ~AlignedBuffer() { std::free(data); }
+    AlignedBuffer(const AlignedBuffer&) = delete;
+    AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+    char* data;
+    size_t size;
+};
+
+/**
+ * @brief Opens a file for writing, with O_DIRECT if requested and supported
+ * @param direct In: requested; out: whether the page cache is actually bypassed
+ */
+int open_file(const std::string& filename, bool& direct) {
+    int flags = O_WRONLY | O_CREAT | O_TRUNC;
+#ifdef O_DIRECT
+    if (direct) {
+        const int fd = ::open(filename.c_str(), flags | O_DIRECT, 0644);
+        if (fd >= 0) return fd;
+        if (errno != EINVAL) throw std::runtime_error(system_error("Impossible to open the file", filename));
+        // Système de fichiers sans O_DIRECT (tmpfs...) : on passe par le cache
+        direct = false;
+    }
+#endif
+    const int fd = ::open(filename.c_str(), flags, 0644);
+    if (fd < 0) {
+        throw std::runtime_error(system_error("Impossible to open the file", filename));
+    }
+#if defined(__APPLE__) && !defined(O_DIRECT)
+    if (direct && fcntl(fd, F_NOCACHE, 1) != 0) direct = false;
+#elif !defined(O_DIRECT)
+    direct = false;
+#endif
+    return fd;
+}
+
+void pwrite_all(int fd, const char* data, size_t bytes, uint64_t offset, const std::string& filename) {
+    while (bytes > 0) {
+        const ssize_t written = ::pwrite(fd, data, bytes, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error(system_error("Error while writing the file", filename));
+        }
+        data += written;
+        bytes -= static_cast<size_t>(written);
+        offset += static_cast<uint64_t>(written);
+    }
+}
+
+/**
+ * @brief Closes a file written with padded blocks, truncating it to its logical size
+ */
+void finish_file(int fd, bool padded, uint64_t size, const std::string& filename) {
+    if (padded && ::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        const std::string message = system_error("Error while truncating the file", filename);
+        ::close(fd);
+        throw std::runtime_error(message);
+    }
+    if (::close(fd) != 0) {
+        throw std::runtime_error(system_error("Error while closing the file", filename));
+    }
+}
+
+/**
+ * @class StreamWriter
+ * @brief std::ofstream backend
+ */
+class StreamWriter : public FileWriter {
+public:
+    explicit StreamWriter(const std::string& filename)
+        : m_filename(filename), m_file(filename, std::ios::binary | std::ios::trunc) {
+        if (!m_file.is_open()) {
+            throw std::runtime_error("Impossible to open the file " + filename);
+        }
+    }
+
+    void write(const void* data, size_t bytes) override {
+        m_file.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+        if (!m_file) throw std::runtime_error("Error while writing the file " + m_filename);
+        m_stats.bytes += bytes;
+        ++m_stats.requests;
+        m_stats.max_in_flight = 1;
+    }
+
+    void close() override {
+        if (!m_file.is_open()) return;
+        m_file.close();
+        if (!m_file) throw std::runtime_error("Error while writing the file " + m_filename);
+    }
+
+    const char* backend() const override { return "stream"; }
+
+private:
+    std::string m_filename;
+    std::ofstream m_file;
+};
+
+/**
+ * @class PwriteWriter
+ * @brief POSIX pwrite backend; stages aligned blocks when the page cache is bypassed
+ */
+class PwriteWriter : public FileWriter {
+public:
+    PwriteWriter(const std::string& filename, const IoOptions& options)
+        : m_filename(filename), m_direct(options.direct), m_fd(open_file(filename, m_direct)),
+          m_buffer(m_direct ? new AlignedBuffer(options.block_size) : nullptr) {}
+
+    ~PwriteWriter() override {
+        if (m_fd >= 0) ::close(m_fd);
+    }
+
+    void write(const void* data, size_t bytes) override {
+        const char* source = static_cast<const char*>(data);
+        if (!m_buffer) {
+            // Sans O_DIRECT : écriture directe depuis la mémoire de l'appelant
+            pwrite_all(m_fd, source, bytes, m_size, m_filename);
+            m_size += bytes;
+            m_stats.bytes += bytes;
+            ++m_stats.requests;
+            m_stats.max_in_flight = 1;
+            return;
+        }
+        while (bytes > 0) {
+            const size_t n = std::min(bytes, m_buffer->size - m_fill);
+            std::memcpy(m_buffer->data + m_fill, source, n);
+            m_fill += n;
+            source += n;
+            bytes -= n;
+            m_size += n;
+            if (m_fill == m_buffer->size) flush_block(m_fill);
+        }
+    }
+
+    void close() override {
+        if (m_fd < 0) return;
+        if (m_buffer && m_fill > 0) {
+            const size_t padded = round_up(m_fill, ALIGNMENT);
+            std::memset(m_buffer->data + m_fill, 0, padded - m_fill);
+            flush_block(padded);
+        }
+        const int fd = m_fd;
+        m_fd = -1;
+        finish_file(fd, m_buffer != nullptr, m_size, m_filename);
+    }
+
+    const char* backend() const override { return m_direct ? "pwrite+O_DIRECT" : "pwrite"; }
+
+private:
+    void flush_block(size_t bytes) {
+        pwrite_all(m_fd, m_buffer->data, bytes, m_offset, m_filename);
+        m_offset += bytes;
+        m_stats.bytes += bytes;
+        ++m_stats.requests;
+        m_stats.max_in_flight = 1;
+        m_fill = 0;
+    }
+
+    std::string m_filename;
+    bool m_direct;
+    int m_fd;
+    std::unique_ptr<AlignedBuffer> m_buffer;    ///< Staging block (O_DIRECT only)
+    size_t m_fill = 0;                          ///< Bytes in the staging block
+    uint64_t m_offset = 0;                      ///< File offset of the next block
+    uint64_t m_size = 0;                        ///< Logical size of the file
+};
+
+#ifdef HEAT_HAVE_IO_URING
+
+/**
+ * @class IoUring
+ * @brief Minimal io_uring ring (setup, write submission, completion) over the raw system calls
+ */
+class IoUring {
+public:
+    /**
+     * @brief Sets the ring up
+     * @return false if io_uring is not available or does not support IORING_OP_WRITE
+     */
+    bool setup(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        m_fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (m_fd < 0) return false;
+        if (!supports_write()) {
+            teardown();
+            return false;
+        }
+
+        m_sqLength = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        m_cqLength = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single) m_sqLength = m_cqLength = std::max(m_sqLength, m_cqLength);
+
+        m_sq = ::mmap(nullptr, m_sqLength, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+        m_cq = single ? m_sq
+                      : ::mmap(nullptr, m_cqLength, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+        m_sqeLength = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = ::mmap(nullptr, m_sqeLength, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+        if (m_sq == MAP_FAILED || m_cq == MAP_FAILED || sqes == MAP_FAILED) {
+            if (sqes != MAP_FAILED) ::munmap(sqes, m_sqeLength);
+            teardown();
+            return false;
+        }
+        m_sqes = static_cast<io_uring_sqe*>(sqes);
+
+        char* sq = static_cast<char*>(m_sq);
+        m_sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        m_sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        m_sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        char* cq = static_cast<char*>(m_cq);
+        m_cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        m_cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        m_cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    ~IoUring() { teardown(); }
+
+    /**
+     * @brief Submits one write (the caller never exceeds the ring size)
+     */
+    void submit_write(int fd, const char* data, size_t bytes, uint64_t offset, uint64_t user_data) {
+        const unsigned tail = *m_sqTail;
+        const unsigned index = tail & m_sqMask;
+        io_uring_sqe& sqe = m_sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_WRITE;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<uint64_t>(data);
+        sqe.len = static_cast<uint32_t>(bytes);
+        sqe.off = offset;
+        sqe.user_data = user_data;
+        m_sqArray[index] = index;
+        __atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+
+        while (::syscall(__NR_io_uring_enter, m_fd, 1, 0, 0, nullptr, 0) < 0) {
+            if (errno != EINTR && errno != EAGAIN) throw std::runtime_error(std::string("io_uring_enter: ") + std::strerror(errno));
+        }
+    }
+
+    /**
+     * @brief Waits for the next completion
+     * @return (user_data, result) of the completed request
+     */
+    std::pair<uint64_t, int> wait() {
+        for (;;) {
+            const unsigned head = *m_cqHead;
+            if (head != __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE)) {
+                const io_uring_cqe& cqe = m_cqes[head & m_cqMask];
+                const std::pair<uint64_t, int> completion(cqe.user_data, cqe.res);
+                __atomic_store_n(m_cqHead, head + 1, __ATOMIC_RELEASE);
+                return completion;
+            }
+            if (::syscall(__NR_io_uring_enter, m_fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno != EINTR) {
+                throw std::runtime_error(std::string("io_uring_enter: ") + std::strerror(errno));
+            }
+        }
+    }
+
+private:
+    /**
+     * @brief Asks the kernel whether IORING_OP_WRITE is supported (older kernels only have WRITEV)
+     */
+    bool supports_write() const {
+        constexpr unsigned OPS = 256;
+        std::vector<char> buffer(sizeof(io_uring_probe) + OPS * sizeof(io_uring_probe_op), 0);
+        io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+        // Sans IORING_REGISTER_PROBE (noyau < 5.6), IORING_OP_WRITE n'existe pas non plus
+        if (::syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_PROBE, probe, OPS) < 0) return false;
+        return probe->last_op >= IORING_OP_WRITE && (probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED);
+    }
+
+    void teardown() {
+        if (m_sqes) ::munmap(m_sqes, m_sqeLength);
+        if (m_cq && m_cq != MAP_FAILED && m_cq != m_sq) ::munmap(m_cq, m_cqLength);
+        if (m_sq && m_sq != MAP_FAILED) ::munmap(m_sq, m_sqLength);
+        if (m_fd >= 0) ::close(m_fd);
+        m_sqes = nullptr;
+        m_sq = m_cq = nullptr;
+        m_fd = -1;
+    }
+
+    int m_fd = -1;
+    void* m_sq = nullptr;
+    void* m_cq = nullptr;
+    size_t m_sqLength = 0, m_cqLength = 0, m_sqeLength = 0;
+    io_uring_sqe* m_sqes = nullptr;
+    io_uring_cqe* m_cqes = nullptr;
+    unsigned* m_sqTail = nullptr;
+    unsigned* m_sqArray = nullptr;
+    unsigned* m_cqHead = nullptr;
+    unsigned* m_cqTail = nullptr;
+    unsigned m_sqMask = 0, m_cqMask = 0;
+};
+
+/**
+ * @class IoUringWriter
+ * @brief io_uring backend: queue_depth aligned blocks, each written asynchronously
+ */
+class IoUringWriter : public FileWriter {
+public:
+    IoUringWriter(const std::string& filename, const IoOptions& options, std::unique_ptr<IoUring> ring)
+        : m_filename(filename), m_direct(options.direct), m_fd(open_file(filename, m_direct)), m_ring(std::move(ring)) {
+        for (size_t b = 0; b < std::max<size_t>(1, options.queue_depth); ++b) {
+            m_blocks.emplace_back(new AlignedBuffer(options.block_size));
+            m_free.push_back(b);
+        }
+        m_current = take_block();
+    }
+
+    ~IoUringWriter() override {
+        if (m_fd < 0) return;
+        // Toutes les écritures en vol lisent encore les blocs : on les attend, erreurs ignorées
+        while (m_inFlight > 0) {
+            try {
+                m_ring->wait();
+            } catch (...) {
+                // Anneau inutilisable : les blocs sont abandonnés plutôt que libérés sous le noyau
+                for (std::unique_ptr<AlignedBuffer>& block : m_blocks) block.release();
+                break;
+            }
+            --m_inFlight;
+        }
+        ::close(m_fd);
+    }
+
+    void write(const void* data, size_t bytes) override {
+        const char* source = static_cast<const char*>(data);
+        while (bytes > 0) {
+            AlignedBuffer& block = *m_blocks[m_current];
+            const size_t n = std::min(bytes, block.size - m_fill);
+            std::memcpy(block.data + m_fill, source, n);
+            m_fill += n;
+            source += n;
+            bytes -= n;
+            m_size += n;
+            if (m_fill == block.size) {
+                submit(m_fill);
+                m_current = take_block();
+            }
+        }
+    }
+
+    void close() override {
+        if (m_fd < 0) return;
+        if (m_fill > 0) {
+            size_t bytes = m_fill;
+            if (m_direct) {
+                bytes = round_up(m_fill, ALIGNMENT);
+                std::memset(m_blocks[m_current]->data + m_fill, 0, bytes - m_fill);
+            }
+            submit(bytes);
+        }
+        while (m_inFlight > 0) complete_one();
+        const int fd = m_fd;
+        m_fd = -1;
+        finish_file(fd, m_direct, m_size, m_filename);
+    }
+
+    const char* backend() const override { return m_direct ? "io_uring+O_DIRECT" : "io_uring"; }
+
+private:
+    void submit(size_t bytes) {
+        m_starts.resize(m_blocks.size());
+        m_lengths.resize(m_blocks.size());
+        m_offsets.resize(m_blocks.size());
+        m_starts[m_current] = 0;
+        m_lengths[m_current] = bytes;
+        m_offsets[m_current] = m_offset;
+        m_ring->submit_write(m_fd, m_blocks[m_current]->data, bytes, m_offset, m_current);
+        m_offset += bytes;
+        ++m_inFlight;
+        ++m_stats.requests;
+        m_stats.max_in_flight = std::max(m_stats.max_in_flight, m_inFlight);
+        m_fill = 0;
+    }
+
+    size_t take_block() {
+        while (m_free.empty()) complete_one();
+        const size_t block = m_free.back();
+        m_free.pop_back();
+        return block;
+    }
+
+    void complete_one() {
+        const std::pair<uint64_t, int> completion = m_ring->wait();
+        const size_t block = static_cast<size_t>(completion.first);
+        --m_inFlight;
+        if (completion.second < 0) {
+            errno = -completion.second;
+            throw std::runtime_error(system_error("Error while writing the file", m_filename));
+        }
+        const size_t written = static_cast<size_t>(completion.second);
+        if (written < m_lengths[block]) {
+            // Écriture partielle (rare) : le reste est resoumis, depuis un offset
+            // aligné en O_DIRECT (l'éventuel recouvrement réécrit les mêmes octets)
+            if (written == 0) {
+                throw std::runtime_error("Error while writing the file " + m_filename + ": no progress");
+            }
+            const size_t done = m_direct ? written / ALIGNMENT * ALIGNMENT : written;
+            m_starts[block] += done;
+            m_lengths[block] -= done;
+            m_offsets[block] += done;
+            m_ring->submit_write(m_fd, m_blocks[block]->data + m_starts[block], m_lengths[block],
+                                 m_offsets[block], block);
+            ++m_inFlight;
+            ++m_stats.requests;
+            return;
+        }
+        m_stats.bytes += m_starts[block] + m_lengths[block];
+        m_free.push_back(block);
+    }
+
+    std::string m_filename;
+    bool m_direct;
+    int m_fd;
+    std::unique_ptr<IoUring> m_ring;
+    std::vector<std::unique_ptr<AlignedBuffer>> m_blocks;   ///< queue_depth staging blocks
+    std::vector<size_t> m_free;                             ///< Blocks not in flight
+    std::vector<size_t> m_starts;                           ///< Start of the submitted range per block
+    std::vector<size_t> m_lengths;                          ///< Submitted length per block
+    std::vector<uint64_t> m_offsets;                        ///< Submitted offset per block
+    size_t m_current = 0;                                   ///< Block being filled
+    size_t m_fill = 0;                                      ///< Bytes in the current block
+    size_t m_inFlight = 0;                                  ///< Submitted, not completed
+    uint64_t m_offset = 0;                                  ///< File offset of the next block
+    uint64_t m_size = 0;                                    ///< Logical size of the file
+};
+
+#endif  // HEAT_HAVE_IO_URING
+
+}  // namespace
+
+IoOptions IoOptions::from_parameters(const Parameters& params) {
+    IoOptions options;
+    options.backend = params.getString("io_backend", options.backend);
+    options.direct = params.getInt("io_direct", 0) != 0;
+    options.queue_depth = static_cast<size_t>(std::max(1L, params.getInt("io_queue_depth", static_cast<long>(options.queue_depth))));
+    options.block_size = round_up(static_cast<size_t>(std::max(1L, params.getInt("io_block_size", static_cast<long>(options.block_size)))), ALIGNMENT);
+    if (options.backend != "stream" && options.backend != "pwrite" && options.backend != "io_uring") {
+        throw std::runtime_error("Unknown io_backend " + options.backend + " (stream, pwrite or io_uring)");
+    }
+    return options;
+}
+
+std::unique_ptr<FileWriter> FileWriter::open(const std::string& filename, const IoOptions& options) {
+    if (options.backend == "io_uring") {
+#ifdef HEAT_HAVE_IO_URING
+        std::unique_ptr<IoUring> ring(new IoUring());
+        if (ring->setup(static_cast<unsigned>(options.queue_depth))) {
+            return std::unique_ptr<FileWriter>(new IoUringWriter(filename, options, std::move(ring)));
+        }
+#endif
+        static std::atomic<bool> warned(false);
+        if (!warned.exchange(true)) {
+            std::cerr << "io_uring unavailable, falling back to pwrite" << std::endl;
+        }
+        return std::unique_ptr<FileWriter>(new PwriteWriter(filename, options));
+    }
+    if (options.backend == "pwrite" || options.direct) {
+        return std::unique_ptr<FileWriter>(new PwriteWriter(filename, options));
+    }
+    return std::unique_ptr<FileWriter>(new StreamWriter(filename));
+}
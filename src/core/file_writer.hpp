@@ -0,0 +1,93 @@
+/**
+ * @file file_writer.hpp
+ * @brief Sequential file writers with selectable I/O backends
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ *
+ * Every binary output of the solver (snapshots, checkpoints, ...) goes
+ * through FileWriter, whose backend is chosen with the io_backend parameter:
+ * - "stream": std::ofstream, through the page cache (default);
+ * - "pwrite": POSIX pwrite, optionally with O_DIRECT (io_direct = 1);
+ * - "io_uring": Linux io_uring with up to io_queue_depth writes of
+ *   io_block_size bytes in flight, optionally with O_DIRECT. Falls back to
+ *   pwrite when io_uring or its IORING_OP_WRITE opcode is unavailable
+ *   (kernel older than 5.6, seccomp, non-Linux).
+ *
+ * With O_DIRECT, data is staged in page-aligned blocks, the last block is
+ * padded and the file is truncated to its real size on close.
+ */
+
+#ifndef FILE_WRITER_HPP
+#define FILE_WRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "parameters.hpp"
+
+/**
+ * @struct IoOptions
+ * @brief Backend selection and tuning of FileWriter
+ */
+struct IoOptions {
+    std::string backend = "stream";     ///< "stream", "pwrite" or "io_uring"
+    bool direct = false;                ///< Bypass the page cache (O_DIRECT / F_NOCACHE)
+    size_t queue_depth = 8;             ///< io_uring: writes in flight
+    size_t block_size = 1 << 20;        ///< Size of the staged blocks (multiple of 4096)
+
+    /**
+     * @brief Reads io_backend, io_direct, io_queue_depth and io_block_size
+     * @throw std::runtime_error for an unknown backend
+     */
+    static IoOptions from_parameters(const Parameters& params);
+};
+
+/**
+ * @class FileWriter
+ * @brief Writes a file sequentially, from start to end
+ */
+class FileWriter {
+public:
+    /**
+     * @struct Stats
+     * @brief Completion tracking of a writer
+     */
+    struct Stats {
+        uint64_t bytes = 0;         ///< Bytes written to the file (before truncation)
+        uint64_t requests = 0;      ///< Write requests issued
+        size_t max_in_flight = 0;   ///< Largest number of concurrent requests
+    };
+
+    virtual ~FileWriter() = default;
+
+    /**
+     * @brief Appends bytes to the file
+     * @throw std::runtime_error on a write error
+     */
+    virtual void write(const void* data, size_t bytes) = 0;
+
+    /**
+     * @brief Completes pending writes and closes the file
+     * @throw std::runtime_error on a write error
+     */
+    virtual void close() = 0;
+
+    /**
+     * @brief Name of the backend actually used (after fallback)
+     */
+    virtual const char* backend() const = 0;
+
+    const Stats& stats() const { return m_stats; }
+
+    /**
+     * @brief Creates (truncates) a file with the requested backend
+     * @throw std::runtime_error if the file cannot be opened
+     */
+    static std::unique_ptr<FileWriter> open(const std::string& filename, const IoOptions& options);
+
+protected:
+    Stats m_stats;
+};
+
+#endif
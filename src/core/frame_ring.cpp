@@ -0,0 +1,199 @@
+/**
+ * @file frame_ring.cpp
+ * @brief Implementation of the FrameRing and FrameRingReader class methods
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ */
+
+#include "frame_ring.hpp"
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+constexpr char FrameRingHeader::MAGIC[8];
+
+namespace {
+
+constexpr uint64_t PAGE = 4096;
+
+uint64_t align(uint64_t bytes, uint64_t alignment) {
+    return (bytes + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+FrameRing::FrameRing(const std::string& name, const Parameters& params, size_t slots)
+    : name(name)
+    , length(0)
+    , header(nullptr)
+    , base(nullptr)
+{
+    slots = std::max<size_t>(1, slots);
+    const uint64_t count = params.getNtot();
+    const uint64_t slot_data = align(sizeof(FrameSlot), 64);
+    const uint64_t slot_bytes = align(slot_data + count * sizeof(double), PAGE);
+    length = PAGE + slots * slot_bytes;
+
+    // Un anneau resté d'une exécution interrompue est remplacé
+    ::shm_unlink(name.c_str());
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Impossible to create the shared memory " + name);
+    }
+    if (::ftruncate(fd, static_cast<off_t>(length)) != 0) {
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        throw std::runtime_error("Impossible to size the shared memory " + name);
+    }
+    void* address = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        ::shm_unlink(name.c_str());
+        throw std::runtime_error("Impossible to map the shared memory " + name);
+    }
+    base = static_cast<char*>(address);
+
+    header = new (base) FrameRingHeader;
+    header->version = FrameRingHeader::VERSION;
+    header->slots = static_cast<uint32_t>(slots);
+    header->nx = params.getNx();
+    header->ny = params.getNy();
+    header->nz = params.getNz();
+    header->count = count;
+    header->dx = params.getDx();
+    header->dy = params.getDy();
+    header->dz = params.getDz();
+    header->slot_offset = PAGE;
+    header->slot_bytes = slot_bytes;
+    header->slot_data = slot_data;
+    header->published.store(0, std::memory_order_relaxed);
+    header->closed.store(0, std::memory_order_relaxed);
+    for (size_t s = 0; s < slots; ++s) {
+        FrameSlot* slot = new (base + PAGE + s * slot_bytes) FrameSlot;
+        slot->sequence.store(0, std::memory_order_relaxed);
+    }
+    // Le magic rend l'anneau visible aux lecteurs une fois l'en-tête complet
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header->magic, FrameRingHeader::MAGIC, sizeof(header->magic));
+}
+
+FrameRing::~FrameRing() {
+    header->closed.store(1, std::memory_order_release);
+    ::munmap(base, length);
+    ::shm_unlink(name.c_str());
+}
+
+/**
+ * @brief Implementation of the seqlock write
+ *
+ * The slot sequence turns odd before the first value is written and even
+ * again after the last one; the frame counter moves on only then, so a
+ * reader never sees a frame as published while its slot is being written.
+ */
+void FrameRing::publish(const Solution& solution, double time, uint64_t iteration) {
+    const uint64_t frame = header->published.load(std::memory_order_relaxed);
+    char* address = base + header->slot_offset + (frame % header->slots) * header->slot_bytes;
+    FrameSlot* slot = reinterpret_cast<FrameSlot*>(address);
+
+    const uint64_t sequence = slot->sequence.load(std::memory_order_relaxed);
+    slot->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->frame = frame;
+    slot->time = time;
+    slot->iteration = iteration;
+    double* values = reinterpret_cast<double*>(address + header->slot_data);
+    size_t n = 0;
+    for (size_t k = 0; k <= header->nz; ++k)
+        for (size_t j = 0; j <= header->ny; ++j)
+            for (size_t i = 0; i <= header->nx; ++i)
+                values[n++] = solution(i, j, k);
+
+    slot->sequence.store(sequence + 2, std::memory_order_release);
+    header->published.store(frame + 1, std::memory_order_release);
+}
+
+FrameRingReader::FrameRingReader(const std::string& name)
+    : name(name)
+    , length(0)
+    , header(nullptr)
+    , base(nullptr)
+{
+    const int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        throw std::runtime_error("No shared memory " + name);
+    }
+    struct stat status;
+    if (::fstat(fd, &status) != 0 || static_cast<uint64_t>(status.st_size) < PAGE) {
+        ::close(fd);
+        throw std::runtime_error(name + " is not a frame ring");
+    }
+    length = static_cast<size_t>(status.st_size);
+    void* address = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        throw std::runtime_error("Impossible to map the shared memory " + name);
+    }
+    base = static_cast<const char*>(address);
+    header = reinterpret_cast<const FrameRingHeader*>(base);
+
+    const bool valid = std::memcmp(header->magic, FrameRingHeader::MAGIC, sizeof(header->magic)) == 0;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (!valid || header->version != FrameRingHeader::VERSION || header->slots == 0
+        || header->count != (header->nx + 1) * (header->ny + 1) * (header->nz + 1)
+        || header->slot_data + header->count * sizeof(double) > header->slot_bytes
+        || header->slot_offset + header->slots * header->slot_bytes > length) {
+        ::munmap(const_cast<char*>(base), length);
+        throw std::runtime_error(name + " is not a frame ring");
+    }
+}
+
+FrameRingReader::~FrameRingReader() {
+    ::munmap(const_cast<char*>(base), length);
+}
+
+/**
+ * @brief Implementation of the seqlock read
+ *
+ * The copy is kept only if the sequence was even and unchanged around it.
+ * While the slot is being written the reader yields and retries, unless
+ * the solver is already past the frame.
+ */
+bool FrameRingReader::read(uint64_t frame, std::vector<double>& values, FrameInfo& info) const {
+    const uint64_t slots = header->slots;
+    if (frame >= published()) return false;
+    const char* address = base + header->slot_offset + (frame % slots) * header->slot_bytes;
+    const FrameSlot* slot = reinterpret_cast<const FrameSlot*>(address);
+    values.resize(header->count);
+
+    for (;;) {
+        if (published() > frame + slots) return false;
+        const uint64_t before = slot->sequence.load(std::memory_order_acquire);
+        if (before % 2 != 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        info.frame = slot->frame;
+        info.time = slot->time;
+        info.iteration = slot->iteration;
+        std::memcpy(values.data(), address + header->slot_data, header->count * sizeof(double));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->sequence.load(std::memory_order_relaxed) == before) {
+            return info.frame == frame;
+        }
+    }
+}
+
+bool FrameRingReader::read_latest(std::vector<double>& values, FrameInfo& info) const {
+    for (;;) {
+        const uint64_t count = published();
+        if (count == 0) return false;
+        if (read(count - 1, values, info)) return true;
+    }
+}
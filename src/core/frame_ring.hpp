@@ -0,0 +1,161 @@
+/**
+ * @file frame_ring.hpp
+ * @brief Ring of frames in POSIX shared memory for live viewers on the same machine
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ *
+ * The solver publishes the grid into one of N slots, in turn, and viewers
+ * map the ring read-only and copy the frames they want. Each slot is
+ * protected by a seqlock: its sequence is odd while the solver writes it,
+ * so a reader retries (or skips the frame) when the sequence was odd or
+ * changed during its copy. The solver never waits for a reader.
+ *
+ *   offset 0                 FrameRingHeader (magic "HEATSHM", grid, slots, latest frame)
+ *   slot_offset + s * slot_bytes
+ *                            FrameSlot (sequence, frame, time, iteration),
+ *                            then at slot_data the values (float64, x fastest)
+ *
+ * The ring is removed from the namespace when the solver stops; mapped
+ * readers keep their view and see closed set.
+ */
+
+#ifndef FRAME_RING_HPP
+#define FRAME_RING_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "parameters.hpp"
+#include "solution.hpp"
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "The frame ring needs lock-free 64-bit atomics");
+
+/**
+ * @struct FrameRingHeader
+ * @brief Header at the beginning of the shared memory
+ */
+struct FrameRingHeader {
+    static constexpr char MAGIC[8] = {'H', 'E', 'A', 'T', 'S', 'H', 'M', '\0'};
+    static constexpr uint32_t VERSION = 1;
+
+    char magic[8];                  ///< "HEATSHM", set once the header is complete
+    uint32_t version;               ///< Format version
+    uint32_t slots;                 ///< Number of slots
+    uint64_t nx, ny, nz;            ///< Subdivisions in each direction
+    uint64_t count;                 ///< Values per frame ((nx+1)(ny+1)(nz+1))
+    double dx, dy, dz;              ///< Grid spacing
+    uint64_t slot_offset;           ///< Offset of the first slot
+    uint64_t slot_bytes;            ///< Size of a slot, header included
+    uint64_t slot_data;             ///< Offset of the values in a slot
+    std::atomic<uint64_t> published;///< Frames published (the latest is published - 1)
+    std::atomic<uint32_t> closed;   ///< 1 once the solver has stopped
+};
+
+/**
+ * @struct FrameSlot
+ * @brief Header of a slot
+ */
+struct FrameSlot {
+    std::atomic<uint64_t> sequence; ///< Seqlock: odd while the slot is written
+    uint64_t frame;                 ///< Frame number
+    double time;                    ///< Simulated time
+    uint64_t iteration;             ///< Iterations completed
+};
+
+/**
+ * @struct FrameInfo
+ * @brief Description of a frame copied by a reader
+ */
+struct FrameInfo {
+    uint64_t frame;                 ///< Frame number
+    double time;                    ///< Simulated time
+    uint64_t iteration;             ///< Iterations completed
+};
+
+/**
+ * @class FrameRing
+ * @brief Creates the ring and publishes frames into it (solver side)
+ */
+class FrameRing {
+private:
+    std::string name;
+    size_t length;
+    FrameRingHeader* header;
+    char* base;
+
+public:
+    /**
+     * @brief Creates the shared memory, replacing a ring of the same name
+     * @param name POSIX name of the shared memory ("/heat_ring")
+     * @param params Parameters of the grid
+     * @param slots Number of slots
+     * @throw std::runtime_error if the shared memory cannot be created
+     */
+    FrameRing(const std::string& name, const Parameters& params, size_t slots = 4);
+
+    /**
+     * @brief Marks the ring closed and removes its name
+     */
+    ~FrameRing();
+
+    FrameRing(const FrameRing&) = delete;
+    FrameRing& operator=(const FrameRing&) = delete;
+
+    /**
+     * @brief Copies the grid into the next slot
+     */
+    void publish(const Solution& solution, double time, uint64_t iteration);
+
+    uint64_t published() const { return header->published.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @class FrameRingReader
+ * @brief Maps a ring read-only and copies consistent frames (viewer side)
+ */
+class FrameRingReader {
+private:
+    std::string name;
+    size_t length;
+    const FrameRingHeader* header;
+    const char* base;
+
+public:
+    /**
+     * @brief Maps an existing ring
+     * @throw std::runtime_error if there is no ring of that name or it is not a frame ring
+     */
+    explicit FrameRingReader(const std::string& name);
+
+    ~FrameRingReader();
+
+    FrameRingReader(const FrameRingReader&) = delete;
+    FrameRingReader& operator=(const FrameRingReader&) = delete;
+
+    const FrameRingHeader& info() const { return *header; }
+
+    /**
+     * @brief Frames published so far
+     */
+    uint64_t published() const { return header->published.load(std::memory_order_acquire); }
+
+    bool closed() const { return header->closed.load(std::memory_order_acquire) != 0; }
+
+    /**
+     * @brief Copies a frame if it is still in the ring
+     * @param frame Frame number
+     * @param values Destination, resized to count values
+     * @param info Frame description
+     * @return false if the frame was not published yet or already overwritten
+     */
+    bool read(uint64_t frame, std::vector<double>& values, FrameInfo& info) const;
+
+    /**
+     * @brief Copies the latest frame
+     * @return false if nothing was published yet
+     */
+    bool read_latest(std::vector<double>& values, FrameInfo& info) const;
+};
+
+#endif
@@ -1,6 +1,12 @@
 #include "heat_equation.hpp"
+#include "snapshot.hpp"
+#include "checkpoint.hpp"
+#include "vtk_writer.hpp"
+#include "brick_snapshot.hpp"
+#include <algorithm>
 #include <iostream>
 #include <cmath>
+#include <sstream>
 
 HeatEquation::HeatEquation(Parameters params, 
                           std::function<double(double,double,double,double)> f,
@@ -9,18 +15,80 @@ HeatEquation::HeatEquation(Parameters params,
     : params(params)
     , f(f)
     , current_time(0.0)
-    , U_current(params)
-    , U_next(params)
+    , U_current(params, "U_current")
+    , U_next(params, "U_next")
     , timers()
+    , pool(std::make_unique<ThreadPool>(static_cast<size_t>(std::max(1L, params.getInt("num_threads", 1)))))
+    , schedule_grain(static_cast<size_t>(std::max(0L, params.getInt("schedule_grain", 0))))
 {
     timers.add("Calculation");
     timers.add("Others");
+    timers.add("I/O");
     timers.add("Initialization");
 
-    if(!gpu_init){
+    if (params.has("trace_file")) {
+        timers.enable_trace(static_cast<size_t>(params.getInt("trace_capacity", 1 << 16)));
+    }
+    if (params.getInt("perf_counters", 0) != 0) {
+        // Le stencil tourne sur les workers du pool : leurs compteurs s'ajoutent à ceux du solveur
+        if (timers.enable_counters()) {
+            pool->run([](size_t worker) {
+                if (worker > 0) PerfCounters::instance().attach_thread();
+            });
+        }
+    }
+    if (params.getInt("memory_trace", 0) != 0) {
+        MemoryTracker::instance().set_verbose(true);
+    }
+    if (params.getInt("vtk_pieces", 1) > 1 || params.has("brick_prefix") || params.has("incremental_prefix")) {
+        // Pool distinct du calcul : num_threads vaut 1 par défaut, et le profil
+        // de charge du solveur ne mélange pas les phases de sortie
+        output_pool = std::make_unique<ThreadPool>(static_cast<size_t>(std::max(0L, params.getInt("output_threads", 0))));
+    }
+    if (params.has("snapshot_prefix") && params.getInt("async_output", 1) != 0) {
+        writer = std::make_unique<AsyncSnapshotWriter>(
+            params,
+            static_cast<size_t>(std::max(1L, params.getInt("output_buffers", 2))),
+            static_cast<uint32_t>(params.getInt("snapshot_precision", 8)),
+            static_cast<uint32_t>(std::max(0L, params.getInt("snapshot_levels", 0))));
+    }
+    if (params.has("series_file")) {
+        series = std::make_unique<TimeSeriesWriter>(
+            params.getString("series_file", ""), params,
+            static_cast<size_t>(std::max(1L, params.getInt("series_keyframes", 10))),
+            params.getDouble("series_error", 0.0));
+    }
+    if (params.has("incremental_prefix")) {
+        incremental = std::make_unique<IncrementalCheckpoint>(
+            params.getString("incremental_prefix", ""), params,
+            static_cast<size_t>(std::max(1L, params.getInt("incremental_brick_size", 32))),
+            static_cast<size_t>(std::max(1L, params.getInt("incremental_full_every", 8))));
+    }
+    if (params.has("output_trigger")) {
+        trigger = std::make_unique<OutputTrigger>(params);
+    }
+    if (params.has("shm_ring")) {
+        ring = std::make_unique<FrameRing>(params.getString("shm_ring", ""), params,
+                                           static_cast<size_t>(std::max(1L, params.getInt("shm_slots", 4))));
+    }
+    if (params.has("extract_file")) {
+        timers.add("Extraction");
+        extractor = std::make_unique<Extractor>(params.getString("extract_file", ""), params);
+    }
+    if (params.has("metrics_port") || params.has("metrics_file")) {
+        metrics = std::make_unique<MetricsExporter>(
+            static_cast<int>(params.getInt("metrics_port", 0)),
+            params.getString("metrics_file", ""),
+            std::chrono::milliseconds(std::max(10L, params.getInt("metrics_interval_ms", 1000))));
+    }
+
+    if (params.has("initial_snapshot")) {
+        load_initial_state(params.getString("initial_snapshot", ""));
+    } else if(!gpu_init){
         timers("Initialization").start();
+        // g n'est évalué qu'une fois : U_next reçoit une copie (ses bords ne sont jamais recalculés)
         U_current.initialize(g);
-        U_next.initialize(g);
+        std::copy(U_current.get_data(), U_current.get_data() + U_current.size(), U_next.get_data());
         timers("Initialization").stop();
     }
     
@@ -38,59 +106,225 @@ double HeatEquation::compute_timestep() {
     const size_t ny = params.getNy();
     const size_t nz = params.getNz();
     
-    double total_variation = 0.0;
+    // One partial sum per worker, padded to avoid false sharing
+    struct alignas(64) PartialVariation { double value = 0.0; };
+    std::vector<PartialVariation> partial_variations(pool->size());
+
+    // Compute inside the domain (not at the border), one slab of k-planes per worker,
+    // split in chunks of schedule_grain planes that idle workers may steal
+    pool->parallel_for(1, nz, [&](size_t k_begin, size_t k_end, size_t worker) {
+        double variation = 0.0;
+        for (size_t k = k_begin; k < k_end; ++k) {
+            for (size_t j = 1; j < ny; ++j) {
+                for (size_t i = 1; i < nx; ++i) {
+                    // Compute the discrete laplacian
+                    const double laplacian =
+                        (U_current(i+1,j,k) - 2*U_current(i,j,k) + U_current(i-1,j,k)) / dx2 +
+                        (U_current(i,j+1,k) - 2*U_current(i,j,k) + U_current(i,j-1,k)) / dy2 +
+                        (U_current(i,j,k+1) - 2*U_current(i,j,k) + U_current(i,j,k-1)) / dz2;
+                    
+                    // Compute the force term with current time
+                    const double force = f(i * dx, j * dy, k * dz, current_time);
+                    
+                    const double local_variation = dt * (laplacian + force);
 
-    // Compute inside the domain (not at the border)
-    for (size_t k = 1; k < nz; ++k) {
-        for (size_t j = 1; j < ny; ++j) {
-            for (size_t i = 1; i < nx; ++i) {
-                // Compute the discrete laplacian
-                const double laplacian =
-                    (U_current(i+1,j,k) - 2*U_current(i,j,k) + U_current(i-1,j,k)) / dx2 +
-                    (U_current(i,j+1,k) - 2*U_current(i,j,k) + U_current(i,j-1,k)) / dy2 +
-                    (U_current(i,j,k+1) - 2*U_current(i,j,k) + U_current(i,j,k-1)) / dz2;
-                
-                // Compute the force term with current time
-                const double force = f(i * dx, j * dy, k * dz, current_time);
-                
-                const double local_variation = dt * (laplacian + force);
-                // if (i == 1 && j == 1 && k == 1) {
-                //     std::cout << "CPU Debug at (1,1,1):" << std::endl;
-                //     std::cout << "  variation: " << local_variation << std::endl;
-                //     std::cout << "  laplacian: " << laplacian << std::endl;
-                //     std::cout << "  force: " << force << std::endl;
-                // }
-
-                U_next(i, j, k) = U_current(i, j, k) + local_variation;
-                total_variation += std::abs(local_variation);
+                    U_next(i, j, k) = U_current(i, j, k) + local_variation;
+                    variation += std::abs(local_variation);
+                }
             }
         }
+        partial_variations[worker].value += variation;
+    }, "Laplacian", schedule_grain);
+
+    double total_variation = 0.0;
+    for (const auto& partial : partial_variations) {
+        total_variation += partial.value;
     }
     return total_variation;
 }
 
+size_t HeatEquation::lattice_updates_per_step() const {
+    return (params.getNx() - 1) * (params.getNy() - 1) * (params.getNz() - 1);
+}
+
+StencilCost HeatEquation::stencil_cost() const {
+    // double : lecture de U_current, écriture de U_next (+ write-allocate)
+    // 3 x (2 add + 1 mul + 1 div) + 2 add pour le laplacien,
+    // 2 pour dt * (laplacien + f), 1 pour la mise à jour, 2 pour |.| et la somme
+    return StencilCost{3.0 * sizeof(double), 19.0};
+}
+
+void HeatEquation::display_throughput() const {
+    const size_t max_iterations = params.getMaxIterations();
+    const uint64_t updates = static_cast<uint64_t>(lattice_updates_per_step())
+                           * (max_iterations - std::min(start_iteration, max_iterations));
+    const double loop_seconds = timers("Calculation").get_elapsed_seconds()
+                              + timers("Others").get_elapsed_seconds()
+                              + timers("I/O").get_elapsed_seconds();
+
+    const StencilCost cost = stencil_cost();
+    std::vector<std::pair<std::string, Throughput>> phases = {
+        {"Calculation", Throughput::compute(updates, timers("Calculation").get_elapsed_seconds(), cost)},
+        {"Time loop", Throughput::compute(updates, loop_seconds, cost)}
+    };
+    display_roofline(phases, cost, measure_stream_bandwidth());
+}
+
+void HeatEquation::write_snapshot(size_t iteration) {
+    std::ostringstream filename;
+    filename << params.getString("snapshot_prefix", "snapshot") << "_"
+             << std::setw(8) << std::setfill('0') << iteration << ".snap";
+    if (writer) {
+        writer->submit(U_current, filename.str(), current_time, iteration);
+    } else {
+        Snapshot::write(filename.str(), U_current, params, current_time, iteration,
+                        static_cast<uint32_t>(params.getInt("snapshot_precision", 8)),
+                        static_cast<uint32_t>(std::max(0L, params.getInt("snapshot_levels", 0))));
+    }
+}
+
+void HeatEquation::write_vtk(size_t iteration) {
+    const size_t pieces = static_cast<size_t>(std::max(1L, params.getInt("vtk_pieces", 1)));
+    const uint32_t precision = static_cast<uint32_t>(params.getInt("vtk_precision", 8));
+    std::ostringstream filename;
+    filename << params.getString("vtk_prefix", "solution") << "_"
+             << std::setw(8) << std::setfill('0') << iteration;
+    if (pieces > 1) {
+        VtkWriter::write_pvti(filename.str() + ".pvti", U_current, params, current_time, *output_pool, pieces, precision);
+    } else {
+        VtkWriter::write_vti(filename.str() + ".vti", U_current, params, current_time, precision);
+    }
+}
+
+void HeatEquation::write_bricks(size_t iteration) {
+    std::ostringstream filename;
+    filename << params.getString("brick_prefix", "bricks") << "_"
+             << std::setw(8) << std::setfill('0') << iteration << ".hbrk";
+    const BrickStats stats = BrickSnapshot::write(filename.str(), U_current, params, current_time, iteration, *output_pool,
+                                                  BrickOptions::from_parameters(params));
+    brick_stats += stats;
+    // Pendant la boucle, la console appartient au thread du logger
+    if (progress) {
+        ProgressRecord record;
+        record.kind = ProgressRecord::Kind::Bricks;
+        record.iteration = iteration;
+        record.ratio = stats.ratio();
+        record.max_error = stats.max_error;
+        record.error_bound = stats.error_bound;
+        progress->push(record);
+    } else {
+        std::cout << filename.str() << ": ratio " << std::fixed << std::setprecision(2) << stats.ratio()
+                  << ", max error " << std::scientific << std::setprecision(3) << stats.max_error
+                  << " (bound " << stats.error_bound << ")" << std::endl;
+    }
+}
+
+void HeatEquation::write_outputs(size_t iteration) {
+    const bool snapshot = params.has("snapshot_prefix");
+    const bool vtk = params.has("vtk_prefix");
+    const bool bricks = params.has("brick_prefix");
+    if (!snapshot && !vtk && !bricks && !series && !ring) return;
+    sync_host();
+    if (snapshot) write_snapshot(iteration);
+    if (vtk) write_vtk(iteration);
+    if (bricks) write_bricks(iteration);
+    if (series) series->append(U_current, current_time, iteration);
+    if (ring) ring->publish(U_current, current_time, iteration);
+}
+
+void HeatEquation::restart(const std::string& filename) {
+    timers("Initialization").start();
+    CheckpointState state = Checkpoint::load(filename, params);
+    U_current.swap(state.solution);
+    current_time = state.time;
+    start_iteration = static_cast<size_t>(state.iteration);
+    upload_solution();
+    timers("Initialization").stop();
+    std::cout << "Restarting from " << filename << " at iteration " << start_iteration << std::endl;
+}
+
+/**
+ * @brief Implementation of the initial state loading
+ *
+ * A float64 snapshot of the same grid is mapped and used as the storage of
+ * U_current without a copy; any other snapshot is interpolated onto the
+ * grid. The state is that of time 0: only the values are taken.
+ */
+void HeatEquation::load_initial_state(const std::string& filename) {
+    timers("Initialization").start();
+    const SnapshotHeader header = Snapshot::read_header(filename);
+    const bool same_grid = header.nx == params.getNx() && header.ny == params.getNy() && header.nz == params.getNz();
+    if (same_grid && header.precision == sizeof(double)) {
+        Solution mapped = Snapshot::map(filename, params);
+        U_current.swap(mapped);
+    } else {
+        Snapshot::resample(filename, params, U_current);
+    }
+    std::copy(U_current.get_data(), U_current.get_data() + U_current.size(), U_next.get_data());
+    timers("Initialization").stop();
+    std::cout << "Initial state from " << filename;
+    if (!same_grid) {
+        std::cout << " (resampled from " << header.nx << "x" << header.ny << "x" << header.nz << ")";
+    }
+    std::cout << std::endl;
+}
+
+void HeatEquation::sync_host() {
+    if (host_current) return;
+    sync_solution();
+    host_current = true;
+}
+
+void HeatEquation::write_checkpoint(size_t iteration) {
+    sync_host();
+    Checkpoint::write(params.getString("checkpoint_file", "checkpoint"), U_current, params, current_time, iteration);
+}
+
+void HeatEquation::display_load_balance() const {
+    pool->display_profile();
+}
+
 void HeatEquation::solve() {
     const size_t max_iterations = params.getMaxIterations();
     const size_t output_frequency = params.getOutputFrequency();
     const double dt = params.getDt();
     double variation;
     // std::cout << "iteration,    simulation_time,    variation,    elapsed computation time(ms)" << std::endl;
-    std::cout << std::left 
-          << std::setw(8) << "Iter" 
-          << std::setw(15) << "Sim Time" 
-          << std::setw(15) << "Variation" 
-          << std::setw(10) << "Comp Time (ms)" 
-          << std::endl;
+    // Les lignes de progression sont formatées par un thread de fond
+    if (output_frequency > 0) {
+        progress = std::make_unique<ProgressLogger>(
+            params.getString("progress_format", "console"),
+            params.getString("progress_file", ""));
+    }
+    const double updates_per_step = static_cast<double>(lattice_updates_per_step());
+    const size_t checkpoint_interval = static_cast<size_t>(std::max(0L, params.getInt("checkpoint_interval", 0)));
+    const size_t incremental_interval = static_cast<size_t>(std::max(1L, params.getInt("incremental_interval", 10)));
+    const size_t extract_interval = static_cast<size_t>(std::max(1L, params.getInt("extract_interval", 1)));
+    if (params.has("restart_file")) {
+        restart(params.getString("restart_file", ""));
+    }
     
-    for (size_t iter = 0; iter < max_iterations; ++iter) {
+    for (size_t iter = start_iteration; iter < max_iterations; ++iter) {
+        const bool log_step = output_frequency > 0 && iter % output_frequency == 0;
+        const double calculation_before = log_step ? timers("Calculation").get_elapsed_seconds() : 0.0;
         timers("Calculation").start();
         variation = compute_timestep();
         timers("Calculation").stop();
+        host_current = false;
 
         timers("Others").start();
         current_time += dt;
         U_current.swap(U_next);
+        timers("Others").stop();
 
+        if (extractor && (iter + 1) % extract_interval == 0) {
+            timers("Extraction").start();
+            sync_host();
+            extractor->sample(U_current, current_time, iter + 1);
+            timers("Extraction").stop();
+        }
+
+        timers("I/O").start();
         // if (output_frequency > 0 && iter % output_frequency == 0) {
         //     // std::cout << iter << ",    " << current_time << ",    " << variation << ",    " << timers("Calculation").get_elapsed() << std::endl;
         //     std::cout << std::left
@@ -106,17 +340,120 @@ void HeatEquation::solve() {
         //     //          << ", elapsed time: " << timers("Calculation").get_elapsed() << " ms" << std::endl;
         //     // timers("Calculation").start();
         // }
-        if (output_frequency > 0 && iter % output_frequency == 0) {
-            std::cout << std::left
-                      << std::setw(8) << iter 
-                      << std::scientific << std::setprecision(3)
-                      << std::setw(15) << current_time 
-                      << std::setw(20) << variation 
-                      << std::fixed << std::setw(15) << timers("Calculation").get_elapsed()
-                      << std::endl;
+        if (log_step) {
+            const double calculation_seconds = timers("Calculation").get_elapsed_seconds();
+            ProgressRecord record;
+            record.iteration = iter;
+            record.time = current_time;
+            record.variation = variation;
+            record.step_ns = static_cast<uint64_t>((calculation_seconds - calculation_before) * 1e9);
+            record.elapsed_ms = static_cast<uint64_t>(timers("Calculation").get_elapsed());
+            record.mlups = updates_per_step * (iter + 1 - start_iteration) / calculation_seconds * 1e-6;
+            progress->push(record);
         }
-        timers("Others").stop();
+        bool output = output_frequency > 0 && iter % output_frequency == 0;
+        if (trigger) {
+            trigger->add_step(variation);
+            if (trigger->checks_solution(iter + 1)) sync_host();
+            output = trigger->due(iter + 1, U_current);
+        }
+        if (output) {
+            write_outputs(iter + 1);
+            if (trigger) {
+                if (trigger->uses_solution()) sync_host();
+                trigger->saved(iter + 1, U_current);
+            }
+        }
+        if (checkpoint_interval > 0 && (iter + 1) % checkpoint_interval == 0 && params.has("checkpoint_file")) {
+            write_checkpoint(iter + 1);
+        }
+        if (incremental && (iter + 1) % incremental_interval == 0) {
+            sync_host();
+            incremental->write(U_current, current_time, iter + 1, *output_pool);
+        }
+        if (metrics) {
+            const LatencyHistogram& steps = timers("Calculation").histogram();
+            MetricsSnapshot snapshot;
+            snapshot.iteration = iter + 1;
+            snapshot.max_iterations = max_iterations;
+            snapshot.simulated_time = current_time;
+            snapshot.variation = variation;
+            snapshot.step_p50 = steps.percentile(50) * 1e-9;
+            snapshot.step_p90 = steps.percentile(90) * 1e-9;
+            snapshot.step_p99 = steps.percentile(99) * 1e-9;
+            snapshot.mlups = updates_per_step * (iter + 1 - start_iteration) / timers("Calculation").get_elapsed_seconds() * 1e-6;
+            metrics->publish(snapshot);
+        }
+        timers("I/O").stop();
     }
     // timers("Calculation").stop();
+    if (progress) {
+        progress->close();
+        if (progress->dropped() > 0) {
+            std::cout << "Progress: " << progress->dropped() << " lines dropped (logger queue full)" << std::endl;
+        }
+        progress.reset();
+    }
+    timers.set_lattice_updates(lattice_updates_per_step() * (max_iterations - std::min(start_iteration, max_iterations)));
+
+    if (params.has("checkpoint_file")) {
+        timers("I/O").start();
+        write_checkpoint(std::max(start_iteration, max_iterations));
+        timers("I/O").stop();
+    }
+
+    if (writer) {
+        timers("I/O").start();
+        writer->flush();
+        timers("I/O").stop();
+        timers.set_background("Snapshot writer", writer->write_seconds(), writer->stall_seconds());
+    }
+
+    if (series) {
+        timers("I/O").start();
+        series->close();
+        timers("I/O").stop();
+        const TimeSeriesStats& stats = series->stats();
+        std::cout << "Time series: " << stats.frames << " frames (" << stats.keyframes << " keyframes), "
+                  << MemoryTracker::format_bytes(stats.raw_bytes) << " -> "
+                  << MemoryTracker::format_bytes(stats.stored_bytes) << " (ratio "
+                  << std::fixed << std::setprecision(2) << stats.ratio() << ", max error "
+                  << std::scientific << std::setprecision(3) << stats.max_error << ")" << std::endl;
+    }
+
+    if (trigger) {
+        std::cout << "Output trigger (" << trigger->name() << " >= " << trigger->get_threshold() << "): "
+                  << trigger->outputs() << " outputs in " << max_iterations - std::min(start_iteration, max_iterations)
+                  << " iterations" << std::endl;
+    }
+
+    if (extractor) {
+        timers("Extraction").start();
+        extractor->close();
+        timers("Extraction").stop();
+        std::cout << "Extraction: " << extractor->extracts().size() << " extracts, " << extractor->steps()
+                  << " steps, " << MemoryTracker::format_bytes(extractor->bytes()) << std::endl;
+    }
+
+    if (incremental && incremental->stats().checkpoints > 0) {
+        const IncrementalStats& stats = incremental->stats();
+        std::cout << "Incremental checkpoints: " << stats.checkpoints << " (" << stats.bases << " full), "
+                  << stats.bricks_written << " of " << stats.bricks_total << " bricks written, "
+                  << MemoryTracker::format_bytes(stats.bytes) << std::endl;
+    }
+
+    if (brick_stats.bricks > 0) {
+        std::cout << "Brick snapshots: " << MemoryTracker::format_bytes(brick_stats.raw_bytes) << " -> "
+                  << MemoryTracker::format_bytes(brick_stats.stored_bytes) << " (ratio "
+                  << std::fixed << std::setprecision(2) << brick_stats.ratio() << ", max error "
+                  << std::scientific << std::setprecision(3) << brick_stats.max_error
+                  << ", bound " << brick_stats.error_bound << ")" << std::endl;
+    }
+
+    if (params.has("trace_file")) {
+        const std::string trace_file = params.getString("trace_file", "");
+        timers.write_trace(trace_file);
+        std::cout << "Trace written to " << trace_file << std::endl;
+    }
     
 }
\ No newline at end of file
@@ -4,7 +4,19 @@
 #include "parameters.hpp"
 #include "solution.hpp"
 #include "timer.hpp"
+#include "throughput.hpp"
+#include "thread_pool.hpp"
+#include "metrics_exporter.hpp"
+#include "async_snapshot_writer.hpp"
+#include "brick_snapshot.hpp"
+#include "time_series.hpp"
+#include "incremental_checkpoint.hpp"
+#include "extraction.hpp"
+#include "frame_ring.hpp"
+#include "output_trigger.hpp"
+#include "progress_logger.hpp"
 #include <functional>
+#include <memory>
 
 class HeatEquation {
 public:
@@ -15,6 +27,20 @@ protected:
     Solution U_next;
     std::function<double(double, double, double, double)> f;
     double current_time;
+    std::unique_ptr<ThreadPool> pool;  // Threads du calcul CPU (paramètre num_threads)
+    std::unique_ptr<ThreadPool> output_pool;  // Threads des sorties en parallèle (paramètre output_threads)
+    size_t schedule_grain;             // Plans par morceau, 0 = un bloc statique par thread
+    std::unique_ptr<MetricsExporter> metrics;  // Métriques en direct (metrics_port / metrics_file)
+    std::unique_ptr<AsyncSnapshotWriter> writer;  // Écriture des snapshots en arrière-plan (async_output)
+    BrickStats brick_stats;  // Tailles cumulées des snapshots en briques
+    std::unique_ptr<TimeSeriesWriter> series;  // Trames clés et deltas des sorties (series_file)
+    size_t start_iteration = 0;  // Itérations déjà faites (reprise depuis restart_file)
+    std::unique_ptr<IncrementalCheckpoint> incremental;  // Checkpoints des briques modifiées (incremental_prefix)
+    std::unique_ptr<Extractor> extractor;  // Sondes, coupes et lignes in situ (extract_file)
+    std::unique_ptr<FrameRing> ring;  // Anneau en mémoire partagée pour les visualiseurs (shm_ring)
+    std::unique_ptr<OutputTrigger> trigger;  // Sorties sur changement de la solution (output_trigger)
+    std::unique_ptr<ProgressLogger> progress;  // Lignes de progression et rapports de sortie (progress_format)
+    bool host_current = false;  // U_current déjà synchronisé depuis le dernier compute_timestep
     
 
     // Calcule une itération et retourne la variation maximale
@@ -22,6 +48,42 @@ protected:
 // protected:  // instead of private so that sub-classes can override it
     virtual double compute_timestep();
 
+    // Nombre de points mis à jour par compute_timestep (normalisation des compteurs)
+    virtual size_t lattice_updates_per_step() const;
+
+    // Trafic mémoire et opérations flottantes d'une mise à jour du stencil
+    virtual StencilCost stencil_cost() const;
+
+    // Met U_current à jour avant une sortie (copie depuis le GPU pour Metal)
+    virtual void sync_solution() {}
+
+    // Appelle sync_solution() au plus une fois par itération
+    void sync_host();
+
+    // Écrit U_current dans <snapshot_prefix>_<iteration>.snap
+    void write_snapshot(size_t iteration);
+
+    // Écrit U_current dans <vtk_prefix>_<iteration>.vti (ou .pvti en vtk_pieces morceaux)
+    void write_vtk(size_t iteration);
+
+    // Écrit U_current compressé en briques dans <brick_prefix>_<iteration>.hbrk
+    void write_bricks(size_t iteration);
+
+    // Copie U_current vers le GPU après une reprise
+    virtual void upload_solution() {}
+
+    // Reprend l'état (U_current, temps, itération) d'un checkpoint
+    void restart(const std::string& filename);
+
+    // Prend U_current (et U_next) d'un snapshot, mappé ou rééchantillonné, au lieu d'évaluer g
+    void load_initial_state(const std::string& filename);
+
+    // Écrit un checkpoint atomique dans checkpoint_file
+    void write_checkpoint(size_t iteration);
+
+    // Synchronise U_current une fois puis appelle chaque sortie configurée
+    void write_outputs(size_t iteration);
+
 public:
     HeatEquation(Parameters params, 
                  std::function<double(double,double,double,double)> f,
@@ -31,6 +93,13 @@ public:
     const Solution& get_solution() const { return U_current; }
     double get_current_time() const { return current_time; }
     void solve();
+
+    // Affiche MLUPS, GB/s et GFLOP/s par phase face à la bande passante mesurée
+    void display_throughput() const;
+
+    // Affiche le temps calcul / vol / attente de chaque thread et le déséquilibre
+    void display_load_balance() const;
+    const ThreadPool& thread_pool() const { return *pool; }
 };
 
 #endif
\ No newline at end of file
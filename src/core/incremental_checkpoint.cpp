@@ -0,0 +1,251 @@
+/**
+ * @file incremental_checkpoint.cpp
+ * @brief Implementation of the IncrementalCheckpoint class methods
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ */
+
+#include "incremental_checkpoint.hpp"
+#include "checkpoint.hpp"
+#include "file_writer.hpp"
+#include "snapshot.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <dirent.h>
+
+constexpr char IncrementalHeader::MAGIC[8];
+
+namespace {
+
+// Empreinte FNV-1a par mots de 64 bits des valeurs d'une brique
+uint64_t hash_values(const std::vector<double>& values) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (double value : values) {
+        uint64_t word;
+        std::memcpy(&word, &value, sizeof(word));
+        hash = (hash ^ word) * 0x100000001b3ULL;
+        hash ^= hash >> 29;
+    }
+    return hash;
+}
+
+}  // namespace
+
+IncrementalCheckpoint::IncrementalCheckpoint(const std::string& prefix, const Parameters& params,
+                                             size_t brick_size, size_t full_every, int level)
+    : prefix(prefix)
+    , params(params)
+    , grid(params.getNx(), params.getNy(), params.getNz(), std::max<size_t>(1, brick_size))
+    , full_every(std::max<size_t>(1, full_every))
+    , level(level)
+    , sequence(0)
+    , base(0)
+    , has_base(false)
+    , hashes(grid.bricks(), 0)
+{
+    // La taille stockée d'une brique tient sur 32 bits dans les entrées
+    if (grid.max_brick_bytes() > UINT32_MAX) {
+        throw std::runtime_error("incremental_brick_size " + std::to_string(grid.edge) + " is too large (bricks over 4 GiB)");
+    }
+    const std::vector<uint64_t> existing = list(prefix);
+    if (!existing.empty()) {
+        sequence = existing.back() + 1;
+    }
+}
+
+std::string IncrementalCheckpoint::filename(const std::string& prefix, uint64_t sequence) {
+    std::ostringstream name;
+    name << prefix << "_" << std::setw(8) << std::setfill('0') << sequence << ".ickp";
+    return name.str();
+}
+
+std::vector<uint64_t> IncrementalCheckpoint::list(const std::string& prefix) {
+    const size_t slash = prefix.find_last_of('/');
+    const std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : prefix.substr(0, slash));
+    const std::string stem = (slash == std::string::npos ? prefix : prefix.substr(slash + 1)) + "_";
+
+    std::vector<uint64_t> sequences;
+    DIR* dir = ::opendir(directory.c_str());
+    if (!dir) return sequences;
+    while (const dirent* entry = ::readdir(dir)) {
+        const std::string name = entry->d_name;
+        if (name.size() != stem.size() + 8 + 5 || name.compare(0, stem.size(), stem) != 0
+            || name.compare(name.size() - 5, 5, ".ickp") != 0) {
+            continue;
+        }
+        const std::string digits = name.substr(stem.size(), 8);
+        if (std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            sequences.push_back(std::stoull(digits));
+        }
+    }
+    ::closedir(dir);
+    std::sort(sequences.begin(), sequences.end());
+    return sequences;
+}
+
+/**
+ * @brief Implementation of the incremental write
+ *
+ * Hashing and compression run per brick on the pool; only the dirty
+ * bricks are kept, so the file is written in one sequential pass. The
+ * hashes are those of the values written, so the next checkpoint compares
+ * against what a restore would rebuild.
+ */
+void IncrementalCheckpoint::write(const Solution& solution, double time, uint64_t iteration, ThreadPool& pool) {
+    const bool full = !has_base || sequence - base >= full_every;
+    const size_t bricks = grid.bricks();
+
+    std::vector<std::vector<uint8_t>> encoded(bricks);
+    std::vector<uint32_t> codecs(bricks);
+    std::vector<char> dirty(bricks, 0);
+    pool.parallel_for(0, bricks, [&](size_t first, size_t last, size_t) {
+        std::vector<double> values;
+        for (size_t b = first; b < last; ++b) {
+            const BrickRegion region = grid.region(b);
+            BrickSnapshot::gather(solution, region, values);
+            const uint64_t hash = hash_values(values);
+            if (full || hash != hashes[b]) {
+                codecs[b] = BrickSnapshot::encode(values, level, encoded[b]);
+                hashes[b] = hash;
+                dirty[b] = 1;
+            }
+        }
+    }, "Incremental checkpoint", 1);
+
+    std::vector<IncrementalEntry> entries;
+    for (size_t b = 0; b < bricks; ++b) {
+        if (dirty[b]) entries.push_back(IncrementalEntry{b, 0, static_cast<uint32_t>(encoded[b].size()), codecs[b]});
+    }
+
+    IncrementalHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, IncrementalHeader::MAGIC, sizeof(header.magic));
+    header.version = IncrementalHeader::VERSION;
+    header.endian_check = IncrementalHeader::ENDIAN_CHECK;
+    header.nx = params.getNx();
+    header.ny = params.getNy();
+    header.nz = params.getNz();
+    header.brick_size = grid.edge;
+    header.bricks = bricks;
+    header.params_hash = Snapshot::params_hash(params);
+    header.time = time;
+    header.iteration = iteration;
+    header.sequence = sequence;
+    header.base = full ? sequence : base;
+    header.stored = entries.size();
+
+    uint64_t offset = sizeof(header) + entries.size() * sizeof(IncrementalEntry);
+    for (IncrementalEntry& entry : entries) {
+        entry.offset = offset;
+        offset += entry.bytes;
+    }
+
+    const std::string target = filename(prefix, sequence);
+    const std::string temporary = target + ".tmp";
+    std::unique_ptr<FileWriter> file = FileWriter::open(temporary, IoOptions::from_parameters(params));
+    file->write(&header, sizeof(header));
+    file->write(entries.data(), entries.size() * sizeof(IncrementalEntry));
+    for (const IncrementalEntry& entry : entries) {
+        file->write(encoded[entry.brick].data(), entry.bytes);
+    }
+    file->close();
+    Checkpoint::commit(temporary, target);
+
+    // La nouvelle base rend la chaîne précédente inutile
+    if (full && has_base) {
+        for (uint64_t old = base; old < sequence; ++old) {
+            std::remove(filename(prefix, old).c_str());
+        }
+    }
+    if (full) {
+        base = sequence;
+        has_base = true;
+        ++m_stats.bases;
+    }
+    ++sequence;
+    ++m_stats.checkpoints;
+    m_stats.bricks_written += entries.size();
+    m_stats.bricks_total += bricks;
+    m_stats.bytes += offset;
+}
+
+IncrementalHeader IncrementalCheckpoint::read_header(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Impossible to open the file " + filename);
+    }
+    IncrementalHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, IncrementalHeader::MAGIC, sizeof(header.magic)) != 0) {
+        throw std::runtime_error(filename + " is not an incremental checkpoint");
+    }
+    if (header.version != IncrementalHeader::VERSION) {
+        throw std::runtime_error(filename + ": unsupported incremental checkpoint version " + std::to_string(header.version));
+    }
+    if (header.endian_check != IncrementalHeader::ENDIAN_CHECK) {
+        throw std::runtime_error(filename + ": incremental checkpoint written with another byte order");
+    }
+    if (header.brick_size == 0 || header.stored > header.bricks || header.base > header.sequence
+        || header.bricks != BrickGrid(header.nx, header.ny, header.nz, header.brick_size).bricks()) {
+        throw std::runtime_error(filename + ": inconsistent incremental checkpoint header");
+    }
+    return header;
+}
+
+/**
+ * @brief Implementation of the restore
+ *
+ * Every file of the chain, base first, overwrites the bricks it stores, so
+ * each brick ends with its value at the latest checkpoint.
+ */
+IncrementalState IncrementalCheckpoint::restore(const std::string& prefix, const Parameters& params, Solution& solution) {
+    const std::vector<uint64_t> sequences = list(prefix);
+    if (sequences.empty()) {
+        throw std::runtime_error("No incremental checkpoint " + prefix + "_*.ickp");
+    }
+    const IncrementalHeader latest = read_header(filename(prefix, sequences.back()));
+    if (latest.params_hash != Snapshot::params_hash(params) || solution.size() != params.getNtot()) {
+        throw std::runtime_error(filename(prefix, latest.sequence) + ": checkpoint written with other parameters (grid or time step differ)");
+    }
+
+    const BrickGrid grid(latest.nx, latest.ny, latest.nz, latest.brick_size);
+    std::vector<uint8_t> stored;
+    std::vector<double> values;
+    for (uint64_t sequence = latest.base; sequence <= latest.sequence; ++sequence) {
+        const std::string name = filename(prefix, sequence);
+        const IncrementalHeader header = read_header(name);
+        if (header.sequence != sequence || header.base != latest.base || header.brick_size != latest.brick_size
+            || header.params_hash != latest.params_hash) {
+            throw std::runtime_error(name + ": does not belong to the chain of " + filename(prefix, latest.sequence));
+        }
+
+        std::ifstream file(name, std::ios::binary);
+        std::vector<IncrementalEntry> entries(header.stored);
+        file.seekg(sizeof(header));
+        file.read(reinterpret_cast<char*>(entries.data()), entries.size() * sizeof(IncrementalEntry));
+        for (const IncrementalEntry& entry : entries) {
+            if (entry.brick >= header.bricks) {
+                throw std::runtime_error(name + ": invalid brick " + std::to_string(entry.brick));
+            }
+            stored.resize(entry.bytes);
+            file.seekg(entry.offset);
+            file.read(reinterpret_cast<char*>(stored.data()), stored.size());
+            if (!file) {
+                throw std::runtime_error("Error while reading the file " + name);
+            }
+            const BrickRegion region = grid.region(entry.brick);
+            try {
+                BrickSnapshot::decode(stored, entry.codec, region, values);
+            } catch (const std::runtime_error&) {
+                throw std::runtime_error(name + ": corrupted brick " + std::to_string(entry.brick));
+            }
+            BrickSnapshot::scatter(values, region, solution);
+        }
+    }
+    return IncrementalState{latest.time, latest.iteration, latest.sequence, latest.base};
+}
@@ -0,0 +1,159 @@
+/**
+ * @file incremental_checkpoint.hpp
+ * @brief Incremental checkpoints that only write the bricks changed since the previous one
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ *
+ * The grid is split into bricks (see BrickGrid). Each checkpoint hashes
+ * every brick in parallel and writes to <prefix>_<sequence>.ickp only the
+ * bricks whose hash changed since the previous checkpoint. Every
+ * full_every-th checkpoint is a full base holding all bricks; once a base
+ * is on disk, the files of the previous chain are removed.
+ *
+ *   offset 0                 IncrementalHeader (magic "HEATINC", grid, sequence, base, ...)
+ *   sizeof(header)           IncrementalEntry per stored brick (brick, offset, size, codec)
+ *   then                     the stored bricks (lossless brick codecs)
+ *
+ * The latest state is the base of the latest file with all the files of
+ * its chain applied in order. Each file is written atomically (see
+ * Checkpoint::commit).
+ */
+
+#ifndef INCREMENTAL_CHECKPOINT_HPP
+#define INCREMENTAL_CHECKPOINT_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "brick_snapshot.hpp"
+#include "parameters.hpp"
+#include "solution.hpp"
+#include "thread_pool.hpp"
+
+/**
+ * @struct IncrementalHeader
+ * @brief Fixed header at the beginning of an incremental checkpoint
+ */
+struct IncrementalHeader {
+    static constexpr char MAGIC[8] = {'H', 'E', 'A', 'T', 'I', 'N', 'C', '\0'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t ENDIAN_CHECK = 0x01020304;
+
+    char magic[8];              ///< "HEATINC"
+    uint32_t version;           ///< Format version
+    uint32_t endian_check;      ///< ENDIAN_CHECK in the byte order of the writer
+    uint64_t nx, ny, nz;        ///< Subdivisions in each direction
+    uint64_t brick_size;        ///< Points per brick edge
+    uint64_t bricks;            ///< Bricks of the grid
+    uint64_t params_hash;       ///< Snapshot::params_hash of the run
+    double time;                ///< Simulated time
+    uint64_t iteration;         ///< Iterations completed
+    uint64_t sequence;          ///< Number of this checkpoint
+    uint64_t base;              ///< Sequence of the full base of the chain (== sequence for a base)
+    uint64_t stored;            ///< Bricks stored in this file
+};
+
+/**
+ * @struct IncrementalEntry
+ * @brief Location of a stored brick
+ */
+struct IncrementalEntry {
+    uint64_t brick;             ///< Brick number in the BrickGrid
+    uint64_t offset;            ///< Offset of the brick in the file
+    uint32_t bytes;             ///< Stored size
+    uint32_t codec;             ///< BrickIndexEntry::CODEC_RAW or CODEC_SHUFFLE_ZLIB
+};
+
+/**
+ * @struct IncrementalStats
+ * @brief Totals of the incremental checkpoints of a run
+ */
+struct IncrementalStats {
+    uint64_t checkpoints = 0;   ///< Checkpoints written
+    uint64_t bases = 0;         ///< Of which full bases
+    uint64_t bricks_written = 0;///< Bricks written
+    uint64_t bricks_total = 0;  ///< Bricks that full checkpoints would have written
+    uint64_t bytes = 0;         ///< Size of the files
+};
+
+/**
+ * @struct IncrementalState
+ * @brief Position of a restored state
+ */
+struct IncrementalState {
+    double time;                ///< Simulated time
+    uint64_t iteration;         ///< Iterations completed
+    uint64_t sequence;          ///< Latest checkpoint applied
+    uint64_t base;              ///< Full base of its chain
+};
+
+/**
+ * @class IncrementalCheckpoint
+ * @brief Writes a chain of incremental checkpoints and restores the latest state
+ */
+class IncrementalCheckpoint {
+private:
+    std::string prefix;
+    Parameters params;
+    BrickGrid grid;
+    size_t full_every;
+    int level;
+    uint64_t sequence;                  // Numéro du prochain checkpoint
+    uint64_t base;                      // Base de la chaîne en cours
+    bool has_base;
+    std::vector<uint64_t> hashes;       // Empreinte de chaque brique au dernier checkpoint
+    IncrementalStats m_stats;
+
+public:
+    /**
+     * @brief Prepares a chain; numbering continues after existing files of the prefix
+     * @param prefix Files are named <prefix>_<sequence>.ickp
+     * @param params Parameters of the run (grid, hash, io_* options)
+     * @param brick_size Points per brick edge
+     * @param full_every Checkpoints per chain, base included (1: full checkpoints only)
+     * @param level zlib compression level
+     * @throw std::runtime_error if a brick of brick_size could exceed the 4 GiB of an entry
+     */
+    IncrementalCheckpoint(const std::string& prefix, const Parameters& params,
+                          size_t brick_size = 32, size_t full_every = 8, int level = 1);
+
+    /**
+     * @brief Writes the bricks changed since the previous checkpoint, or a full base
+     * @param solution Grid values
+     * @param time Simulated time
+     * @param iteration Iterations completed
+     * @param pool Threads hashing and compressing the bricks
+     * @throw std::runtime_error if the file cannot be written
+     */
+    void write(const Solution& solution, double time, uint64_t iteration, ThreadPool& pool);
+
+    const IncrementalStats& stats() const { return m_stats; }
+
+    /**
+     * @brief Name of a checkpoint of the chain
+     */
+    static std::string filename(const std::string& prefix, uint64_t sequence);
+
+    /**
+     * @brief Sequences of the checkpoint files of a prefix, in increasing order
+     */
+    static std::vector<uint64_t> list(const std::string& prefix);
+
+    /**
+     * @brief Reads and validates the header of an incremental checkpoint
+     * @throw std::runtime_error if the file is not a valid incremental checkpoint
+     */
+    static IncrementalHeader read_header(const std::string& filename);
+
+    /**
+     * @brief Rebuilds the latest state from its base and the following checkpoints
+     * @param prefix Prefix of the chain
+     * @param params Parameters of the run, whose hash must match
+     * @param solution Destination, of the grid of params
+     * @return Time, iteration and sequence of the restored state
+     * @throw std::runtime_error if there is no checkpoint or the chain is broken
+     */
+    static IncrementalState restore(const std::string& prefix, const Parameters& params, Solution& solution);
+};
+
+#endif
@@ -33,13 +33,26 @@ MetalHeatEquation::MetalHeatEquation(Parameters params,
         timers("Initialization").start();
         
         // std::cout << "Calling initializeMetal()" << std::endl;
-        initializeMetal();
+        {
+            TRACE_SCOPE("Metal setup");
+            initializeMetal();
+        }
         
         // std::cout << "Calling setupBuffers()" << std::endl;
-        setupBuffers();
+        {
+            TRACE_SCOPE("Buffer setup");
+            setupBuffers();
+        }
         
         // std::cout << "Calling initializeSolutionGPU()" << std::endl;
-        initializeSolutionGPU();
+        if (params.has("initial_snapshot")) {
+            // État initial déjà chargé par HeatEquation : copié dans les buffers, g n'est pas évalué
+            TRACE_SCOPE("GPU initialization");
+            upload_solution();
+        } else {
+            TRACE_SCOPE("GPU initialization");
+            initializeSolutionGPU();
+        }
         
         timers("Initialization").stop();
         // std::cout << "Initialization completed successfully" << std::endl;
@@ -283,6 +296,8 @@ void MetalHeatEquation::initializeMetal() {
         throw;
     }
 
+    MemoryTracker::Allocation sourceAllocation("Shader source", shaderSource.size());
+
     // Compile shader
     // std::cout << "Starting shader compilation..." << std::endl;
     NS::Error* error = nullptr;
@@ -405,6 +420,12 @@ void MetalHeatEquation::setupBuffers() {
     const size_t num_reduction_groups = (num_interior_points + 255) / 256;  // 256 threads par groupe
     resultBuffer = device->newBuffer(num_reduction_groups * sizeof(float), MTL::ResourceStorageModeShared);
     debugBuffer = device->newBuffer(3 * sizeof(float), MTL::ResourceStorageModeShared);
+
+    bufferAllocations.emplace_back("GPU current", dataSize);
+    bufferAllocations.emplace_back("GPU next", dataSize);
+    bufferAllocations.emplace_back("GPU variation", num_interior_points * sizeof(float));
+    bufferAllocations.emplace_back("GPU reduction", num_reduction_groups * sizeof(float));
+    bufferAllocations.emplace_back("GPU parameters", sizeof(GPUParameters) + 3 * sizeof(float));
 }
 
 double MetalHeatEquation::compute_timestep() {
@@ -418,53 +439,61 @@ double MetalHeatEquation::compute_timestep() {
     auto gpuParams = static_cast<GPUParameters*>(paramsBuffer->contents());
     gpuParams->current_time = static_cast<float>(current_time);
     
-    // Premier kernel : calcul de l'équation de la chaleur
-    auto commandBuffer = commandQueue->commandBuffer();
-    auto computeEncoder = commandBuffer->computeCommandEncoder();
-    
-    computeEncoder->setComputePipelineState(pipelineState);
-    computeEncoder->setBuffer(currentBuffer, 0, 0);
-    computeEncoder->setBuffer(nextBuffer, 0, 1);
-    computeEncoder->setBuffer(paramsBuffer, 0, 2);
-    
-    MTL::Size gridSize = MTL::Size(params.getNx(), params.getNy(), params.getNz());
-    MTL::Size threadgroupSize = MTL::Size(8, 8, 8);
-    
-    computeEncoder->dispatchThreads(gridSize, threadgroupSize);
-    computeEncoder->endEncoding();
-    
-    // Deuxième kernel : calcul des variations locales
-    computeEncoder = commandBuffer->computeCommandEncoder();
-    computeEncoder->setComputePipelineState(pipelineStateVariation);
-    computeEncoder->setBuffer(currentBuffer, 0, 0);
-    computeEncoder->setBuffer(nextBuffer, 0, 1);
-    computeEncoder->setBuffer(paramsBuffer, 0, 2);
-    computeEncoder->setBuffer(variationBuffer, 0, 3);
-    computeEncoder->setBuffer(debugBuffer, 0, 4);
-    
-    computeEncoder->dispatchThreads(gridSize, threadgroupSize);
-    computeEncoder->endEncoding();
-    
-    // Troisième kernel : réduction pour calculer la somme totale
-    computeEncoder = commandBuffer->computeCommandEncoder();
-    computeEncoder->setComputePipelineState(pipelineStateReduce);
-    
     uint32_t total_elements = (params.getNx() - 2) * (params.getNy() - 2) * (params.getNz() - 2);
     uint32_t threads_per_group = 256;
     uint32_t num_groups = (total_elements + threads_per_group - 1) / threads_per_group;
-    
-    MTL::Size reduceGridSize = MTL::Size(total_elements, 1, 1);
-    MTL::Size reduceThreadgroupSize = MTL::Size(threads_per_group, 1, 1);
-    
-    computeEncoder->setBuffer(variationBuffer, 0, 0);
-    computeEncoder->setBuffer(resultBuffer, 0, 1);
-    
-    computeEncoder->dispatchThreads(reduceGridSize, reduceThreadgroupSize);
-    computeEncoder->endEncoding();
+
+    // Encodage des trois kernels dans un seul command buffer
+    MTL::CommandBuffer* commandBuffer = nullptr;
+    {
+        TRACE_SCOPE("Encode kernels");
+        // Premier kernel : calcul de l'équation de la chaleur
+        commandBuffer = commandQueue->commandBuffer();
+        auto computeEncoder = commandBuffer->computeCommandEncoder();
+
+        computeEncoder->setComputePipelineState(pipelineState);
+        computeEncoder->setBuffer(currentBuffer, 0, 0);
+        computeEncoder->setBuffer(nextBuffer, 0, 1);
+        computeEncoder->setBuffer(paramsBuffer, 0, 2);
+
+        MTL::Size gridSize = MTL::Size(params.getNx(), params.getNy(), params.getNz());
+        MTL::Size threadgroupSize = MTL::Size(8, 8, 8);
+
+        computeEncoder->dispatchThreads(gridSize, threadgroupSize);
+        computeEncoder->endEncoding();
+
+        // Deuxième kernel : calcul des variations locales
+        computeEncoder = commandBuffer->computeCommandEncoder();
+        computeEncoder->setComputePipelineState(pipelineStateVariation);
+        computeEncoder->setBuffer(currentBuffer, 0, 0);
+        computeEncoder->setBuffer(nextBuffer, 0, 1);
+        computeEncoder->setBuffer(paramsBuffer, 0, 2);
+        computeEncoder->setBuffer(variationBuffer, 0, 3);
+        computeEncoder->setBuffer(debugBuffer, 0, 4);
+
+        computeEncoder->dispatchThreads(gridSize, threadgroupSize);
+        computeEncoder->endEncoding();
+
+        // Troisième kernel : réduction pour calculer la somme totale
+        computeEncoder = commandBuffer->computeCommandEncoder();
+        computeEncoder->setComputePipelineState(pipelineStateReduce);
+
+        MTL::Size reduceGridSize = MTL::Size(total_elements, 1, 1);
+        MTL::Size reduceThreadgroupSize = MTL::Size(threads_per_group, 1, 1);
+
+        computeEncoder->setBuffer(variationBuffer, 0, 0);
+        computeEncoder->setBuffer(resultBuffer, 0, 1);
+
+        computeEncoder->dispatchThreads(reduceGridSize, reduceThreadgroupSize);
+        computeEncoder->endEncoding();
+    }
     
     // Exécuter et attendre
-    commandBuffer->commit();
-    commandBuffer->waitUntilCompleted();
+    {
+        TRACE_SCOPE("GPU wait");
+        commandBuffer->commit();
+        commandBuffer->waitUntilCompleted();
+    }
     
     // float* debug_values = static_cast<float*>(debugBuffer->contents());
     // std::cout << "GPU Debug at (1,1,1):" << std::endl;
@@ -473,10 +502,13 @@ double MetalHeatEquation::compute_timestep() {
     // std::cout << "  force: " << debug_values[2] << std::endl;
     
     // Lire le résultat final
-    float* result = static_cast<float*>(resultBuffer->contents());
     double total_variation = 0.0;
-    for (uint32_t i = 0; i < num_groups; ++i) {
-        total_variation += result[i];
+    {
+        TRACE_SCOPE("Host reduction");
+        float* result = static_cast<float*>(resultBuffer->contents());
+        for (uint32_t i = 0; i < num_groups; ++i) {
+            total_variation += result[i];
+        }
     }
     
     // Swap buffers
@@ -488,4 +520,29 @@ double MetalHeatEquation::compute_timestep() {
 
     
     return total_variation;
+}
+
+size_t MetalHeatEquation::lattice_updates_per_step() const {
+    // Les kernels ne traitent que les points 1..n-2 dans chaque direction
+    return (params.getNx() - 2) * (params.getNy() - 2) * (params.getNz() - 2);
+}
+
+void MetalHeatEquation::sync_solution() {
+    // Les buffers sont en mémoire partagée : currentBuffer contient le dernier pas
+    U_current.initialize(currentBuffer, currentBuffer->length());
+}
+
+void MetalHeatEquation::upload_solution() {
+    // Les deux buffers reçoivent l'état repris : les bords de nextBuffer ne sont jamais écrits
+    float* current_data = static_cast<float*>(currentBuffer->contents());
+    float* next_data = static_cast<float*>(nextBuffer->contents());
+    for (size_t i = 0; i < params.getNtot(); ++i) {
+        current_data[i] = next_data[i] = static_cast<float>(U_current.get_data()[i]);
+    }
+}
+
+StencilCost MetalHeatEquation::stencil_cost() const {
+    // float : heat_equation (lecture + écriture), variation (lecture + écriture),
+    // reduce (lecture) ; le laplacien est recalculé par le kernel de variation
+    return StencilCost{5.0 * sizeof(float), 36.0};
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "function_parser.hpp"
 #include <Metal/Metal.hpp>
 #include <functional>
+#include <vector>
 
 class MetalHeatEquation : public HeatEquation {
 private:
@@ -27,9 +28,14 @@ private:
     MTL::Buffer* paramsBuffer;
     MTL::Buffer* variationBuffer;  // Nouveau
     MTL::Buffer* resultBuffer;     // Nouveau
+    std::vector<MemoryTracker::Allocation> bufferAllocations;  // Taille des buffers GPU
     
     void initializeMetal();
     double compute_timestep() override;
+    size_t lattice_updates_per_step() const override;
+    StencilCost stencil_cost() const override;
+    void sync_solution() override;
+    void upload_solution() override;
     void setupBuffers();
     void initializeSolutionGPU();
 
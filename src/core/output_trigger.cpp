@@ -0,0 +1,112 @@
+/**
+ * @file output_trigger.cpp
+ * @brief Implementation of the OutputTrigger class methods
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ */
+
+#include "output_trigger.hpp"
+#include "extraction.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+OutputTrigger::OutputTrigger(const Parameters& params)
+    : threshold(params.getDouble("trigger_threshold", 0.0))
+    , min_interval(static_cast<uint64_t>(std::max(1L, params.getInt("trigger_min_interval", 1))))
+    , max_interval(static_cast<uint64_t>(std::max(0L, params.getInt("trigger_max_interval", 0))))
+    , check_interval(static_cast<uint64_t>(std::max(1L, params.getInt("trigger_check_interval", 1))))
+    , has_saved(false)
+    , last_saved(0)
+    , accumulated(0.0)
+    , m_outputs(0)
+{
+    const std::string name = params.getString("output_trigger", "variation");
+    if (name == "variation") mode = Mode::Variation;
+    else if (name == "probes") mode = Mode::Probes;
+    else if (name == "linf") mode = Mode::Linf;
+    else throw std::runtime_error("Unknown output trigger " + name + " (variation, probes or linf)");
+    if (!(threshold > 0.0)) {
+        throw std::runtime_error("trigger_threshold must be positive");
+    }
+
+    if (mode == Mode::Probes) {
+        // Mêmes sondes que l'extraction, ramenées au point de grille le plus proche
+        const size_t n[3] = {params.getNx(), params.getNy(), params.getNz()};
+        const double d[3] = {params.getDx(), params.getDy(), params.getDz()};
+        for (const ExtractionColumn& probe : Extractor::parse_probes(params.getString("probes", ""))) {
+            std::array<size_t, 3> point;
+            for (int a = 0; a < 3; ++a) {
+                const double f = std::round(probe.position[a] / d[a]);
+                if (!(f >= 0.0 && f <= static_cast<double>(n[a]))) {
+                    throw std::runtime_error("Probe " + std::string(probe.name) + " is outside the domain");
+                }
+                point[a] = static_cast<size_t>(f);
+            }
+            probes.push_back(point);
+        }
+        if (probes.empty()) {
+            throw std::runtime_error("output_trigger=probes needs the probes parameter");
+        }
+    }
+}
+
+const char* OutputTrigger::name() const {
+    switch (mode) {
+    case Mode::Variation: return "variation";
+    case Mode::Probes: return "probes";
+    case Mode::Linf: return "linf";
+    }
+    return "";
+}
+
+bool OutputTrigger::checks_solution(uint64_t iteration) const {
+    return uses_solution() && has_saved && iteration - last_saved >= min_interval
+        && (iteration - last_saved) % check_interval == 0;
+}
+
+double OutputTrigger::change(const Solution& solution) const {
+    double largest = 0.0;
+    if (mode == Mode::Probes) {
+        for (size_t p = 0; p < probes.size(); ++p) {
+            const std::array<size_t, 3>& q = probes[p];
+            largest = std::max(largest, std::fabs(solution(q[0], q[1], q[2]) - reference[p]));
+        }
+    } else {
+        // Arrêt dès que le seuil est atteint : inutile de parcourir le reste
+        const double* values = solution.get_data();
+        const size_t count = solution.size();
+        const size_t block = 4096;
+        for (size_t first = 0; first < count && largest < threshold; first += block) {
+            const size_t last = std::min(count, first + block);
+            for (size_t e = first; e < last; ++e) {
+                largest = std::max(largest, std::fabs(values[e] - reference[e]));
+            }
+        }
+    }
+    return largest;
+}
+
+bool OutputTrigger::due(uint64_t iteration, const Solution& solution) {
+    if (!has_saved) return true;
+    const uint64_t since = iteration - last_saved;
+    if (since < min_interval) return false;
+    if (max_interval > 0 && since >= max_interval) return true;
+    if (mode == Mode::Variation) return accumulated >= threshold;
+    return checks_solution(iteration) && change(solution) >= threshold;
+}
+
+void OutputTrigger::saved(uint64_t iteration, const Solution& solution) {
+    has_saved = true;
+    last_saved = iteration;
+    accumulated = 0.0;
+    ++m_outputs;
+    if (mode == Mode::Probes) {
+        reference.resize(probes.size());
+        for (size_t p = 0; p < probes.size(); ++p) {
+            reference[p] = solution(probes[p][0], probes[p][1], probes[p][2]);
+        }
+    } else if (mode == Mode::Linf) {
+        reference.assign(solution.get_data(), solution.get_data() + solution.size());
+    }
+}
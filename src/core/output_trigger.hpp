@@ -0,0 +1,94 @@
+/**
+ * @file output_trigger.hpp
+ * @brief Event-driven output: write when the solution has changed enough
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ *
+ * Instead of every output_frequency iterations, the outputs are written
+ * when a measure of the change since the last saved frame reaches
+ * trigger_threshold (output_trigger parameter):
+ *   variation   sum of the variations returned by compute_timestep (free)
+ *   probes      largest change of the values at the probes (grid points
+ *               nearest to the probes parameter, see extraction.hpp)
+ *   linf        largest change of any grid value (keeps a copy of the grid)
+ *
+ * The probes and linf measures need the solution on the host, so they are
+ * only evaluated every trigger_check_interval iterations. Outputs are at
+ * least trigger_min_interval iterations apart, and at most
+ * trigger_max_interval (if set), so slow phases still get frames.
+ */
+
+#ifndef OUTPUT_TRIGGER_HPP
+#define OUTPUT_TRIGGER_HPP
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "parameters.hpp"
+#include "solution.hpp"
+
+/**
+ * @class OutputTrigger
+ * @brief Decides at each iteration whether the outputs are due
+ */
+class OutputTrigger {
+public:
+    enum class Mode { Variation, Probes, Linf };
+
+private:
+    Mode mode;
+    double threshold;
+    uint64_t min_interval;
+    uint64_t max_interval;              // 0 : pas de sortie forcée
+    uint64_t check_interval;
+    bool has_saved;
+    uint64_t last_saved;                // Itération de la dernière sortie
+    double accumulated;                 // Somme des variations depuis la dernière sortie
+    std::vector<std::array<size_t, 3>> probes;
+    std::vector<double> reference;      // Valeurs à la dernière sortie (sondes ou grille)
+    uint64_t m_outputs;
+
+public:
+    /**
+     * @brief Reads output_trigger and the trigger_* parameters
+     * @throw std::runtime_error for an unknown mode, a threshold that is not positive or no probes
+     */
+    explicit OutputTrigger(const Parameters& params);
+
+    /**
+     * @brief Adds the variation of a step (every iteration)
+     */
+    void add_step(double variation) { accumulated += variation; }
+
+    /**
+     * @brief Whether due() will read the solution at this iteration (which must then be on the host)
+     */
+    bool checks_solution(uint64_t iteration) const;
+
+    /**
+     * @brief Whether the outputs are due after iteration
+     * @param solution Current grid, read only if checks_solution(iteration)
+     */
+    bool due(uint64_t iteration, const Solution& solution);
+
+    /**
+     * @brief Records the frame just written as the new reference
+     * @param solution Current grid on the host (read in the probes and linf modes)
+     */
+    void saved(uint64_t iteration, const Solution& solution);
+
+    /**
+     * @brief Whether saved() reads the solution
+     */
+    bool uses_solution() const { return mode != Mode::Variation; }
+
+    uint64_t outputs() const { return m_outputs; }         ///< Outputs triggered
+    const char* name() const;                              ///< Name of the mode
+    double get_threshold() const { return threshold; }
+
+private:
+    double change(const Solution& solution) const;
+};
+
+#endif
@@ -0,0 +1,423 @@
+/**
+ * @file snapshot.cpp
+ * @brief Implementation of the Snapshot class methods
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ */
+
+#include "snapshot.hpp"
+#include "file_writer.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+constexpr char SnapshotHeader::MAGIC[8];
+
+static_assert(sizeof(SnapshotHeader) <= SnapshotHeader::DATA_OFFSET, "Snapshot header larger than its page");
+
+namespace {
+
+/**
+ * @class Pyramid
+ * @brief Builds the downsampled levels plane by plane, while the values are written
+ *
+ * Each level accumulates the box sums of two planes of the level below;
+ * a finished plane is scaled by the number of points of its boxes and
+ * pushed in turn to the next level, so the whole pyramid is built in the
+ * single pass over the full resolution.
+ */
+class Pyramid {
+public:
+    explicit Pyramid(const SnapshotHeader& header) {
+        uint64_t fine[3] = {header.nx + 1, header.ny + 1, header.nz + 1};
+        for (uint64_t l = 0; l < header.levels; ++l) {
+            Level level;
+            std::copy(fine, fine + 3, level.fine);
+            std::copy(header.level[l].points, header.level[l].points + 3, level.points);
+            level.sum.resize(level.points[0] * level.points[1]);
+            level.values.reserve(level.points[0] * level.points[1] * level.points[2]);
+            levels.push_back(std::move(level));
+            std::copy(header.level[l].points, header.level[l].points + 3, fine);
+        }
+    }
+
+    // Ajoute le plan k de la pleine résolution (x le plus rapide)
+    void push(const double* plane, size_t k) { push(0, plane, k); }
+
+    const std::vector<double>& values(size_t l) const { return levels[l].values; }
+
+private:
+    struct Level {
+        uint64_t fine[3];               // Points du niveau inférieur
+        uint64_t points[3];             // Points de ce niveau
+        std::vector<double> sum;        // Sommes des boîtes du plan en cours
+        std::vector<double> values;     // Plans terminés
+    };
+    std::vector<Level> levels;
+
+    void push(size_t l, const double* plane, size_t k) {
+        Level& level = levels[l];
+        const size_t fx = level.fine[0], fy = level.fine[1], fz = level.fine[2];
+        const size_t mx = level.points[0], my = level.points[1];
+        const size_t pairs = fx / 2;
+        if (k % 2 == 0) {
+            std::fill(level.sum.begin(), level.sum.end(), 0.0);
+        }
+        for (size_t j = 0; j < fy; ++j) {
+            const double* __restrict row = plane + j * fx;
+            double* __restrict sum = level.sum.data() + (j / 2) * mx;
+            for (size_t i = 0; i < pairs; ++i) {
+                sum[i] += row[2 * i] + row[2 * i + 1];
+            }
+            if (fx % 2 != 0) sum[pairs] += row[fx - 1];
+        }
+        if (k % 2 == 0 && k + 1 < fz) return;
+
+        // Plan terminé : moyenne sur les points présents dans chaque boîte
+        const double cz = k % 2 == 1 ? 2.0 : 1.0;
+        const size_t first = level.values.size();
+        level.values.resize(first + mx * my);
+        double* __restrict out = level.values.data() + first;
+        for (size_t J = 0; J < my; ++J) {
+            const double scale = 1.0 / (2.0 * cz * (2 * J + 1 < fy ? 2.0 : 1.0));
+            const double* __restrict sum = level.sum.data() + J * mx;
+            for (size_t I = 0; I < pairs; ++I) {
+                out[J * mx + I] = sum[I] * scale;
+            }
+            if (fx % 2 != 0) out[J * mx + pairs] = sum[pairs] * scale * 2.0;
+        }
+        if (l + 1 < levels.size()) {
+            push(l + 1, out, k / 2);
+        }
+    }
+};
+
+// Écrit des valeurs en float64, ou en float32 par un petit tampon de conversion
+void write_values(FileWriter& file, const double* values, size_t count, uint32_t precision, std::vector<float>& buffer) {
+    if (precision == 8) {
+        file.write(values, count * sizeof(double));
+        return;
+    }
+    buffer.resize(16384);
+    for (size_t first = 0; first < count; first += buffer.size()) {
+        const size_t n = std::min(buffer.size(), count - first);
+        for (size_t i = 0; i < n; ++i) buffer[i] = static_cast<float>(values[first + i]);
+        file.write(buffer.data(), n * sizeof(float));
+    }
+}
+
+}  // namespace
+
+SnapshotHeader Snapshot::make_header(const Parameters& params, double time, uint64_t iteration, uint32_t precision,
+                                     uint32_t levels) {
+    if (precision != 4 && precision != 8) {
+        throw std::runtime_error("Snapshot precision must be 4 or 8 bytes");
+    }
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, SnapshotHeader::MAGIC, sizeof(header.magic));
+    header.version = SnapshotHeader::VERSION;
+    header.endian_check = SnapshotHeader::ENDIAN_CHECK;
+    header.nx = params.getNx();
+    header.ny = params.getNy();
+    header.nz = params.getNz();
+    header.count = params.getNtot();
+    header.dx = params.getDx();
+    header.dy = params.getDy();
+    header.dz = params.getDz();
+    header.time = time;
+    header.iteration = iteration;
+    header.precision = precision;
+    header.layout = SnapshotHeader::LAYOUT_SOLUTION;
+    header.data_offset = SnapshotHeader::DATA_OFFSET;
+    header.data_bytes = header.count * precision;
+    header.params_hash = params_hash(params);
+
+    uint64_t points[3] = {header.nx + 1, header.ny + 1, header.nz + 1};
+    uint64_t offset = header.data_offset + header.data_bytes;
+    while (header.levels < std::min(levels, SnapshotHeader::MAX_LEVELS)
+           && (points[0] > 1 || points[1] > 1 || points[2] > 1)) {
+        SnapshotLevel& level = header.level[header.levels++];
+        for (int a = 0; a < 3; ++a) {
+            points[a] = (points[a] + 1) / 2;
+            level.points[a] = points[a];
+        }
+        level.offset = offset;
+        level.bytes = points[0] * points[1] * points[2] * precision;
+        offset += level.bytes;
+    }
+    return header;
+}
+
+uint64_t Snapshot::params_hash(const Parameters& params) {
+    // FNV-1a sur la représentation binaire des paramètres
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    auto mix = [&hash](const void* data, size_t bytes) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < bytes; ++i) {
+            hash ^= p[i];
+            hash *= 0x100000001b3ULL;
+        }
+    };
+    const uint64_t shape[3] = {params.getNx(), params.getNy(), params.getNz()};
+    const double steps[4] = {params.getDx(), params.getDy(), params.getDz(), params.getDt()};
+    mix(shape, sizeof(shape));
+    mix(steps, sizeof(steps));
+    return hash;
+}
+
+/**
+ * @brief Implementation of the snapshot writer
+ *
+ * The header page is written first, then the values straight from the
+ * storage of the Solution (float64) or through a 64 KB conversion buffer
+ * (float32). O_DIRECT backends stage them in aligned blocks.
+ *
+ * With levels, the storage is written plane by plane and each plane,
+ * still in cache, is fed to the pyramid; the levels follow the values.
+ */
+void Snapshot::write(const std::string& filename, const Solution& solution, const Parameters& params,
+                     double time, uint64_t iteration, uint32_t precision, uint32_t levels) {
+    const SnapshotHeader header = make_header(params, time, iteration, precision, levels);
+    if (solution.size() != header.count) {
+        throw std::runtime_error("Solution size mismatch while writing " + filename);
+    }
+
+    std::unique_ptr<FileWriter> file = FileWriter::open(filename, IoOptions::from_parameters(params));
+
+    std::vector<char> page(SnapshotHeader::DATA_OFFSET, 0);
+    std::memcpy(page.data(), &header, sizeof(header));
+    file->write(page.data(), page.size());
+
+    const double* values = solution.get_data();
+    std::vector<float> buffer;
+    if (header.levels == 0) {
+        write_values(*file, values, header.count, precision, buffer);
+    } else {
+        Pyramid pyramid(header);
+        const size_t nx = header.nx, ny = header.ny, nz = header.nz;
+        std::vector<double> plane((nx + 1) * (ny + 1));
+        size_t written = 0;
+        for (size_t k = 0; k <= nz; ++k) {
+            for (size_t j = 0, n = 0; j <= ny; ++j)
+                for (size_t i = 0; i <= nx; ++i)
+                    plane[n++] = solution(i, j, k);
+            pyramid.push(plane.data(), k);
+            // Le stockage du plan k s'arrête à nx*ny*(k + 1)
+            const size_t end = k == nz ? header.count : std::min<size_t>(header.count, nx * ny * (k + 1));
+            write_values(*file, values + written, end - written, precision, buffer);
+            written = end;
+        }
+        for (size_t l = 0; l < header.levels; ++l) {
+            write_values(*file, pyramid.values(l).data(), pyramid.values(l).size(), precision, buffer);
+        }
+    }
+    file->close();
+}
+
+SnapshotHeader Snapshot::read_header(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Impossible to open the file " + filename);
+    }
+    SnapshotHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, SnapshotHeader::MAGIC, sizeof(header.magic)) != 0) {
+        throw std::runtime_error(filename + " is not a snapshot");
+    }
+    if (header.version != SnapshotHeader::VERSION) {
+        throw std::runtime_error(filename + ": unsupported snapshot version " + std::to_string(header.version));
+    }
+    if (header.endian_check != SnapshotHeader::ENDIAN_CHECK) {
+        throw std::runtime_error(filename + ": snapshot written with another byte order");
+    }
+    if (header.layout != SnapshotHeader::LAYOUT_SOLUTION
+        || (header.precision != 4 && header.precision != 8)
+        || header.data_bytes != header.count * header.precision
+        || header.count != (header.nx + 1) * (header.ny + 1) * (header.nz + 1)) {
+        throw std::runtime_error(filename + ": inconsistent snapshot header");
+    }
+
+    if (header.levels > SnapshotHeader::MAX_LEVELS) {
+        throw std::runtime_error(filename + ": inconsistent snapshot header");
+    }
+    for (uint64_t l = 0; l < header.levels; ++l) {
+        const SnapshotLevel& level = header.level[l];
+        if (level.bytes != level.points[0] * level.points[1] * level.points[2] * header.precision
+            || level.offset < header.data_offset + header.data_bytes) {
+            throw std::runtime_error(filename + ": inconsistent snapshot header");
+        }
+    }
+
+    file.seekg(0, std::ios::end);
+    const uint64_t size = static_cast<uint64_t>(file.tellg());
+    if (size < header.data_offset + header.data_bytes
+        || (header.levels > 0 && size < header.level[header.levels - 1].offset + header.level[header.levels - 1].bytes)) {
+        throw std::runtime_error(filename + ": truncated snapshot");
+    }
+    return header;
+}
+
+static void check_grid(const SnapshotHeader& header, const Parameters& params, const std::string& filename) {
+    if (header.nx != params.getNx() || header.ny != params.getNy() || header.nz != params.getNz()) {
+        throw std::runtime_error(filename + ": snapshot grid " + std::to_string(header.nx) + "x"
+                                 + std::to_string(header.ny) + "x" + std::to_string(header.nz)
+                                 + " does not match the parameters");
+    }
+}
+
+/**
+ * @brief Implementation of the snapshot mapping
+ *
+ * The mapping is owned by a shared_ptr whose deleter unmaps it, so it
+ * lives as long as the Solution view or any copy of it.
+ */
+Solution Snapshot::map(const std::string& filename, Parameters& params, bool writable) {
+    const SnapshotHeader header = read_header(filename);
+    check_grid(header, params, filename);
+    if (header.precision != sizeof(double)) {
+        throw std::runtime_error(filename + ": only float64 snapshots can be mapped");
+    }
+
+    const int fd = ::open(filename.c_str(), writable ? O_RDWR : O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Impossible to open the file " + filename);
+    }
+    const size_t length = header.data_offset + header.data_bytes;
+    // Privée en lecture seule : les écritures restent en mémoire (copy-on-write)
+    void* address = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, writable ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        throw std::runtime_error("Impossible to map the file " + filename);
+    }
+
+    std::shared_ptr<const void> mapping(address, [length](const void* pointer) {
+        ::munmap(const_cast<void*>(pointer), length);
+    });
+    double* values = reinterpret_cast<double*>(static_cast<char*>(address) + header.data_offset);
+    return Solution(params, values, mapping);
+}
+
+/**
+ * @brief Implementation of the resampling
+ *
+ * The lower source index and the weight along each axis are computed once
+ * per axis; the snapshot values are read through the mapping with the
+ * index i + nx*(j + ny*k) of the grid that wrote them.
+ */
+void Snapshot::resample(const std::string& filename, const Parameters& params, Solution& solution) {
+    const SnapshotHeader header = read_header(filename);
+    if (solution.size() != params.getNtot()) {
+        throw std::runtime_error("Solution size mismatch while resampling " + filename);
+    }
+
+    const int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Impossible to open the file " + filename);
+    }
+    const size_t length = header.data_offset + header.data_bytes;
+    void* address = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        throw std::runtime_error("Impossible to map the file " + filename);
+    }
+    std::shared_ptr<const void> mapping(address, [length](const void* pointer) {
+        ::munmap(const_cast<void*>(pointer), length);
+    });
+    const char* data = static_cast<const char*>(address) + header.data_offset;
+    const double* f64 = reinterpret_cast<const double*>(data);
+    const float* f32 = reinterpret_cast<const float*>(data);
+    auto source = [&](size_t i, size_t j, size_t k) {
+        const size_t e = i + header.nx * (j + header.ny * k);
+        return header.precision == 8 ? f64[e] : static_cast<double>(f32[e]);
+    };
+
+    // Indice inférieur et poids dans la grille source, pour chaque point de chaque axe
+    const size_t n[3] = {params.getNx(), params.getNy(), params.getNz()};
+    const double d[3] = {params.getDx(), params.getDy(), params.getDz()};
+    const size_t sn[3] = {header.nx, header.ny, header.nz};
+    const double sd[3] = {header.dx, header.dy, header.dz};
+    std::vector<size_t> lower[3];
+    std::vector<double> weight[3];
+    for (int a = 0; a < 3; ++a) {
+        for (size_t p = 0; p <= n[a]; ++p) {
+            const double f = std::min(std::max(p * d[a] / sd[a], 0.0), static_cast<double>(sn[a]));
+            const size_t index = sn[a] == 0 ? 0 : std::min(static_cast<size_t>(f), sn[a] - 1);
+            lower[a].push_back(index);
+            weight[a].push_back(sn[a] == 0 ? 0.0 : f - static_cast<double>(index));
+        }
+    }
+
+    for (size_t k = 0; k <= n[2]; ++k) {
+        const size_t k0 = lower[2][k], k1 = std::min(k0 + 1, sn[2]);
+        const double tz = weight[2][k];
+        for (size_t j = 0; j <= n[1]; ++j) {
+            const size_t j0 = lower[1][j], j1 = std::min(j0 + 1, sn[1]);
+            const double ty = weight[1][j];
+            for (size_t i = 0; i <= n[0]; ++i) {
+                const size_t i0 = lower[0][i], i1 = std::min(i0 + 1, sn[0]);
+                const double tx = weight[0][i];
+                const double c00 = source(i0, j0, k0) * (1 - tx) + source(i1, j0, k0) * tx;
+                const double c10 = source(i0, j1, k0) * (1 - tx) + source(i1, j1, k0) * tx;
+                const double c01 = source(i0, j0, k1) * (1 - tx) + source(i1, j0, k1) * tx;
+                const double c11 = source(i0, j1, k1) * (1 - tx) + source(i1, j1, k1) * tx;
+                solution(i, j, k) = (c00 * (1 - ty) + c10 * ty) * (1 - tz) + (c01 * (1 - ty) + c11 * ty) * tz;
+            }
+        }
+    }
+}
+
+void Snapshot::read(const std::string& filename, Solution& solution) {
+    const SnapshotHeader header = read_header(filename);
+    if (header.count != solution.size()) {
+        throw std::runtime_error(filename + ": snapshot size does not match the solution");
+    }
+
+    std::ifstream file(filename, std::ios::binary);
+    file.seekg(header.data_offset);
+    double* values = solution.get_data();
+    if (header.precision == 8) {
+        file.read(reinterpret_cast<char*>(values), header.data_bytes);
+    } else {
+        std::vector<float> buffer(16384);
+        for (size_t first = 0; first < header.count; first += buffer.size()) {
+            const size_t n = std::min(buffer.size(), static_cast<size_t>(header.count) - first);
+            file.read(reinterpret_cast<char*>(buffer.data()), n * sizeof(float));
+            for (size_t i = 0; i < n; ++i) values[first + i] = buffer[i];
+        }
+    }
+    if (!file) {
+        throw std::runtime_error("Error while reading the file " + filename);
+    }
+}
+
+SnapshotLevel Snapshot::read_level(const std::string& filename, uint32_t level, std::vector<double>& values) {
+    const SnapshotHeader header = read_header(filename);
+    if (level == 0 || level > header.levels) {
+        throw std::runtime_error(filename + ": no level " + std::to_string(level) + " in the snapshot ("
+                                 + std::to_string(header.levels) + " levels)");
+    }
+    const SnapshotLevel& location = header.level[level - 1];
+    const size_t count = location.points[0] * location.points[1] * location.points[2];
+    values.resize(count);
+
+    std::ifstream file(filename, std::ios::binary);
+    file.seekg(location.offset);
+    if (header.precision == 8) {
+        file.read(reinterpret_cast<char*>(values.data()), location.bytes);
+    } else {
+        std::vector<float> buffer(count);
+        file.read(reinterpret_cast<char*>(buffer.data()), location.bytes);
+        std::copy(buffer.begin(), buffer.end(), values.begin());
+    }
+    if (!file) {
+        throw std::runtime_error("Error while reading the file " + filename);
+    }
+    return location;
+}
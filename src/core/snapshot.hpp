@@ -0,0 +1,154 @@
+/**
+ * @file snapshot.hpp
+ * @brief Binary, memory-mappable snapshot format for Solution
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ *
+ * A snapshot is a fixed 4096-byte header followed by the raw grid values:
+ *
+ *   offset 0     SnapshotHeader (magic "HEATSNP", shape, spacing, time, ...)
+ *   offset 4096  nx1*ny1*nz1 values, float64 or float32, native byte order,
+ *                in the layout of Solution (index i + nx*(j + ny*k))
+ *
+ * The data offset is a multiple of the page size, so a float64 snapshot can
+ * be mapped and used directly as the storage of a Solution.
+ *
+ * Optionally, the values are followed by a pyramid of downsampled levels
+ * for previews. Level l + 1 averages boxes of 2x2x2 points of level l
+ * (fewer on the upper faces of odd sizes), so a level has ceil(m / 2)
+ * points along an axis of m points and a spacing twice as large. Each
+ * level is stored dense, x fastest, in the precision of the snapshot, and
+ * located by the table of the header, so a reader loads a coarse level
+ * without touching the full resolution (see Snapshot::read_level).
+ */
+
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "parameters.hpp"
+#include "solution.hpp"
+
+/**
+ * @struct SnapshotLevel
+ * @brief Location of a downsampled level of a snapshot
+ */
+struct SnapshotLevel {
+    uint64_t points[3];         ///< Points along x, y and z
+    uint64_t offset;            ///< Offset of the values in the file
+    uint64_t bytes;             ///< Size of the values
+};
+
+/**
+ * @struct SnapshotHeader
+ * @brief Fixed header at the beginning of a snapshot file
+ */
+struct SnapshotHeader {
+    static constexpr char MAGIC[8] = {'H', 'E', 'A', 'T', 'S', 'N', 'P', '\0'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t ENDIAN_CHECK = 0x01020304;
+    static constexpr uint64_t DATA_OFFSET = 4096;   ///< Taille réservée à l'en-tête (une page)
+    static constexpr uint32_t LAYOUT_SOLUTION = 0;  ///< Index i + nx*(j + ny*k)
+    static constexpr uint32_t MAX_LEVELS = 16;      ///< Niveaux de la pyramide au plus
+
+    char magic[8];              ///< "HEATSNP"
+    uint32_t version;           ///< Format version
+    uint32_t endian_check;      ///< ENDIAN_CHECK in the byte order of the writer
+    uint64_t nx, ny, nz;        ///< Subdivisions in each direction
+    uint64_t count;             ///< Number of values
+    double dx, dy, dz;          ///< Grid spacing
+    double time;                ///< Simulated time
+    uint64_t iteration;         ///< Iterations completed
+    uint32_t precision;         ///< Bytes per value: 8 (float64) or 4 (float32)
+    uint32_t layout;            ///< LAYOUT_SOLUTION
+    uint64_t data_offset;       ///< Offset of the values in the file
+    uint64_t data_bytes;        ///< Size of the values
+    uint64_t params_hash;       ///< Snapshot::params_hash of the writer (0 in older files)
+    uint64_t levels;            ///< Downsampled levels after the values (0 in older files)
+    SnapshotLevel level[MAX_LEVELS];   ///< Levels 1 to levels, from the finest
+};
+
+/**
+ * @class Snapshot
+ * @brief Writes and reads Solution snapshots
+ */
+class Snapshot {
+public:
+    /**
+     * @brief Writes a snapshot
+     * @param filename Path of the file
+     * @param solution Grid values, streamed directly from its storage in float64
+     * @param params Parameters of the grid
+     * @param time Simulated time
+     * @param iteration Iterations completed
+     * @param precision 8 (float64, mappable) or 4 (float32, converted through a small buffer)
+     * @param levels Downsampled levels to append (stops earlier once a level is a single point)
+     * @throw std::runtime_error if the file cannot be written
+     *
+     * The file is written with the backend selected by the io_* parameters (see FileWriter).
+     */
+    static void write(const std::string& filename, const Solution& solution, const Parameters& params,
+                      double time, uint64_t iteration, uint32_t precision = 8, uint32_t levels = 0);
+
+    /**
+     * @brief Builds the header describing a grid and the table of its levels
+     */
+    static SnapshotHeader make_header(const Parameters& params, double time, uint64_t iteration, uint32_t precision,
+                                      uint32_t levels = 0);
+
+    /**
+     * @brief Hash of the parameters that determine the values of the grid
+     *
+     * Covers the grid shape, spacing and time step, not the run length or
+     * the output options, so a run can be resumed with more iterations.
+     */
+    static uint64_t params_hash(const Parameters& params);
+
+    /**
+     * @brief Reads and validates the header of a snapshot
+     * @throw std::runtime_error if the file is not a valid snapshot
+     */
+    static SnapshotHeader read_header(const std::string& filename);
+
+    /**
+     * @brief Maps a float64 snapshot and views it as a Solution, without copying
+     * @param filename Path of the file
+     * @param params Parameters whose grid must match the snapshot
+     * @param writable Map the file shared and writable (changes go to the file)
+     * @return A view on the mapping, which stays mapped while a copy of the view exists
+     * @throw std::runtime_error if the snapshot is float32 or its grid differs from params
+     */
+    static Solution map(const std::string& filename, Parameters& params, bool writable = false);
+
+    /**
+     * @brief Interpolates a snapshot of another grid into a Solution
+     * @param filename Path of the file (mapped read-only, either precision)
+     * @param params Parameters of the destination grid
+     * @param solution Destination, of the grid of params
+     *
+     * Each point takes the trilinear interpolation of the snapshot at the
+     * same physical position, clamped to the domain of the snapshot.
+     */
+    static void resample(const std::string& filename, const Parameters& params, Solution& solution);
+
+    /**
+     * @brief Reads a snapshot of either precision into a Solution
+     * @param filename Path of the file
+     * @param solution Destination, whose grid must match the snapshot
+     */
+    static void read(const std::string& filename, Solution& solution);
+
+    /**
+     * @brief Reads one downsampled level of a snapshot
+     * @param filename Path of the file
+     * @param level Level, from 1 (half resolution) to header.levels
+     * @param values Destination, resized to the points of the level (x fastest)
+     * @return Location and shape of the level
+     * @throw std::runtime_error if the snapshot has no such level
+     */
+    static SnapshotLevel read_level(const std::string& filename, uint32_t level, std::vector<double>& values);
+};
+
+#endif
@@ -18,13 +18,50 @@
  * and allocates memory for the solution data array. The constructor
  * uses initialization lists for efficiency and const correctness.
  */
-Solution::Solution(Parameters &params) :
+Solution::Solution(Parameters &params, const std::string& name) :
     params(params),
     nx(params.getNx()), ny(params.getNy()), nz(params.getNz()),
     dx(params.getDx()), dx2(params.getDx2()),
     dy(params.getDy()), dy2(params.getDy2()),
-    dz(params.getDz()), dz2(params.getDz2()) {
-    data.resize(params.getNtot());
+    dz(params.getDz()), dz2(params.getDz2()),
+    count(params.getNtot()) {
+    data.resize(count);
+    values = data.data();
+    allocation = MemoryTracker::Allocation(name, data.size() * sizeof(double));
+}
+
+/**
+ * @brief View constructor implementation
+ *
+ * No memory is allocated: the values are read and written in place.
+ */
+Solution::Solution(Parameters &params, double* external, std::shared_ptr<const void> owner) :
+    values(external), storage(std::move(owner)),
+    params(params),
+    dx(params.getDx()), dy(params.getDy()), dz(params.getDz()),
+    dx2(params.getDx2()), dy2(params.getDy2()), dz2(params.getDz2()),
+    nx(params.getNx()), ny(params.getNy()), nz(params.getNz()),
+    count(params.getNtot()) {
+    if (!storage) {
+        storage = std::shared_ptr<const void>(external, [](const void*) {});  // Stockage non possédé
+    }
+}
+
+/**
+ * @brief Copy constructor implementation
+ *
+ * The copied vector gets its own values pointer; views keep pointing
+ * to the shared storage.
+ */
+Solution::Solution(const Solution& other) :
+    data(other.data), values(nullptr), storage(other.storage),
+    params(other.params),
+    dx(other.dx), dy(other.dy), dz(other.dz),
+    dx2(other.dx2), dy2(other.dy2), dz2(other.dz2),
+    nx(other.nx), ny(other.ny), nz(other.nz),
+    count(other.count),
+    allocation(other.allocation) {
+    values = storage ? other.values : data.data();
 }
 
 /**
@@ -35,7 +72,7 @@ Solution::Solution(Parameters &params) :
  * This provides efficient row-major access to the grid points.
  */
 double& Solution::operator()(size_t i, size_t j, size_t k) {
-    return data[i + nx * (j + ny * k)];
+    return values[i + nx * (j + ny * k)];
 }
 
 /**
@@ -45,7 +82,7 @@ double& Solution::operator()(size_t i, size_t j, size_t k) {
  * indexing formula as the non-const operator.
  */
 const double& Solution::operator()(size_t i, size_t j, size_t k) const {
-    return data[i + nx * (j + ny * k)];
+    return values[i + nx * (j + ny * k)];
 }
 
 /**
@@ -67,14 +104,14 @@ void Solution::initialize(std::function<double(double,double,double)> g) {
 
 void Solution::initialize(MTL::Buffer* buffer, size_t size) {
     // Vérifie que la taille est correcte
-    if (size != data.size() * sizeof(float)) {
+    if (size != count * sizeof(float)) {
         throw std::runtime_error("Buffer size mismatch in GPU initialization");
     }
     
     // Copie les données depuis le buffer GPU
     float* gpu_data = static_cast<float*>(buffer->contents());
-    for (size_t i = 0; i < data.size(); ++i) {
-        data[i] = static_cast<double>(gpu_data[i]);
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = static_cast<double>(gpu_data[i]);
     }
 }
 
@@ -82,8 +119,12 @@ void Solution::initialize(MTL::Buffer* buffer, size_t size) {
  * @brief Implementation of solution swap
  * 
  * Uses the vector's swap method for efficient data exchange
- * without copying the entire arrays.
+ * without copying the entire arrays. Views exchange their storage.
  */
 void Solution::swap(Solution& other) {
     data.swap(other.data);
+    std::swap(values, other.values);
+    std::swap(storage, other.storage);
+    // Les octets suivent le vecteur : un temporaire libéré ne les laisse pas attribués à U_current
+    std::swap(allocation, other.allocation);
 }
\ No newline at end of file
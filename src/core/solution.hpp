@@ -18,7 +18,9 @@
 #include <string>
 #include <cassert>
 #include <cstddef>
+#include <memory>
 #include "parameters.hpp"
+#include "memory_tracker.hpp"
 #include <Metal/Metal.hpp>
 
 /**
@@ -31,21 +33,44 @@
  */
 class Solution {
 private:
-    std::vector<double> data;              ///< Storage for grid point values
+    std::vector<double> data;              ///< Storage for grid point values (empty for a view)
+    double* values;                        ///< Grid point values: data.data() or external storage
+    std::shared_ptr<const void> storage;   ///< Keeps external storage (e.g. a mapping) alive
     Parameters params;                      ///< Simulation parameters
     const double dx, dy, dz;               ///< Grid spacing in each dimension
     const double dx2, dy2, dz2;            ///< Squared grid spacing for computations
     const size_t nx, ny, nz;               ///< Number of grid points in each dimension
+    size_t count;                          ///< Number of values (params.getNtot())
+    MemoryTracker::Allocation allocation;  ///< Bytes of data attributed to the owner name
 
 public:
     /**
      * @brief Constructor
      * @param params Reference to simulation parameters
+     * @param name Owner of the grid in the memory summary
      * 
      * Initializes a solution grid with dimensions and spacing defined
      * in the provided parameters. Allocates memory for the entire grid.
      */
-    Solution(Parameters &params);
+    Solution(Parameters &params, const std::string& name = "Solution");
+
+    /**
+     * @brief View constructor
+     * @param params Reference to simulation parameters
+     * @param external Grid point values, params.getNtot() doubles in the layout of this class
+     * @param owner Object keeping external alive (e.g. a memory mapping), shared by copies
+     *
+     * Builds a Solution over existing storage without copying it, such as a
+     * memory-mapped snapshot. The view is writable if the storage is.
+     */
+    Solution(Parameters &params, double* external, std::shared_ptr<const void> owner);
+
+    /**
+     * @brief Copy constructor
+     *
+     * Owned data is copied; a view copies the view and shares its storage.
+     */
+    Solution(const Solution& other);
     
     /**
      * @brief Grid point access operator
@@ -97,13 +122,23 @@ public:
      * @brief Gets raw pointer to data array
      * @return Pointer to the underlying data array
      */
-    double* get_data() { return data.data(); }
+    double* get_data() { return values; }
 
     /**
      * @brief Gets const raw pointer to data array
      * @return Const pointer to the underlying data array
      */
-    const double* get_data() const { return data.data(); }
+    const double* get_data() const { return values; }
+
+    /**
+     * @brief Gets the number of grid point values
+     */
+    size_t size() const { return count; }
+
+    /**
+     * @brief Tells whether the values live in external storage
+     */
+    bool is_view() const { return storage != nullptr; }
 };
 
 #endif
\ No newline at end of file
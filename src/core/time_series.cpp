@@ -0,0 +1,269 @@
+/**
+ * @file time_series.cpp
+ * @brief Implementation of the TimeSeriesWriter and TimeSeriesReader class methods
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ */
+
+#include "time_series.hpp"
+#include "codec.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+constexpr char TimeSeriesHeader::MAGIC[8];
+
+TimeSeriesWriter::TimeSeriesWriter(const std::string& filename, const Parameters& params,
+                                   size_t keyframe_interval, double error_bound, int level)
+    : file(FileWriter::open(filename, IoOptions::from_parameters(params)))
+    , level(level)
+{
+    if (error_bound < 0.0) {
+        throw std::runtime_error("Time series error bound must be positive");
+    }
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, TimeSeriesHeader::MAGIC, sizeof(header.magic));
+    header.version = TimeSeriesHeader::VERSION;
+    header.endian_check = TimeSeriesHeader::ENDIAN_CHECK;
+    header.nx = params.getNx();
+    header.ny = params.getNy();
+    header.nz = params.getNz();
+    header.count = (header.nx + 1) * (header.ny + 1) * (header.nz + 1);
+    header.dx = params.getDx();
+    header.dy = params.getDy();
+    header.dz = params.getDz();
+    header.keyframe_interval = std::max<size_t>(1, keyframe_interval);
+    header.error_bound = error_bound;
+
+    current.resize(header.count);
+    previous.resize(header.count);
+    file->write(&header, sizeof(header));
+    m_stats.stored_bytes = sizeof(header);
+}
+
+TimeSeriesWriter::~TimeSeriesWriter() {
+    try {
+        close();
+    } catch (const std::exception& error) {
+        std::cerr << "Time series: " << error.what() << std::endl;
+    }
+}
+
+/**
+ * @brief Implementation of the frame encoder
+ *
+ * previous always holds the frame as the reader will reconstruct it, so
+ * lossy deltas are taken against what the reader has, not the exact values.
+ */
+void TimeSeriesWriter::append(const Solution& solution, double time, uint64_t iteration) {
+    if (!file) {
+        throw std::runtime_error("Time series already closed");
+    }
+    size_t n = 0;
+    for (size_t k = 0; k <= header.nz; ++k)
+        for (size_t j = 0; j <= header.ny; ++j)
+            for (size_t i = 0; i <= header.nx; ++i)
+                current[n++] = solution(i, j, k);
+
+    const size_t count = current.size();
+    FrameHeader frame;
+    std::memset(&frame, 0, sizeof(frame));
+    frame.frame = m_stats.frames;
+    frame.iteration = iteration;
+    frame.time = time;
+
+    if (m_stats.frames % header.keyframe_interval == 0) {
+        frame.type = FrameHeader::KEYFRAME;
+        staging.resize(count * sizeof(double));
+        Codec::shuffle(current.data(), count, sizeof(double), staging.data());
+        previous = current;
+        ++m_stats.keyframes;
+    } else if (header.error_bound == 0.0) {
+        frame.type = FrameHeader::DELTA_XOR;
+        std::vector<uint64_t> bits(count);
+        for (size_t e = 0; e < count; ++e) {
+            uint64_t a, b;
+            std::memcpy(&a, &current[e], sizeof(a));
+            std::memcpy(&b, &previous[e], sizeof(b));
+            bits[e] = a ^ b;
+        }
+        staging.resize(count * sizeof(uint64_t));
+        Codec::shuffle(bits.data(), count, sizeof(uint64_t), staging.data());
+        previous = current;
+    } else {
+        frame.type = FrameHeader::DELTA_QUANT;
+        const double step = 2.0 * header.error_bound;
+        std::vector<uint32_t> codes(count);
+        std::vector<double> outliers;
+        for (size_t e = 0; e < count; ++e) {
+            const double q = std::nearbyint((current[e] - previous[e]) / step);
+            const double value = previous[e] + step * q;
+            if (std::isfinite(q) && std::fabs(q) < Codec::MAX_QUANTUM && std::fabs(value - current[e]) <= header.error_bound) {
+                codes[e] = Codec::zigzag(static_cast<long long>(q));
+                m_stats.max_error = std::max(m_stats.max_error, std::fabs(value - current[e]));
+                previous[e] = value;
+            } else {
+                codes[e] = Codec::OUTLIER;
+                outliers.push_back(current[e]);
+                previous[e] = current[e];
+            }
+        }
+        frame.outliers = outliers.size();
+        staging.resize(count * sizeof(uint32_t) + outliers.size() * sizeof(double));
+        Codec::shuffle(codes.data(), count, sizeof(uint32_t), staging.data());
+        if (!outliers.empty()) {
+            std::memcpy(staging.data() + count * sizeof(uint32_t), outliers.data(), outliers.size() * sizeof(double));
+        }
+    }
+    write_frame(frame);
+}
+
+void TimeSeriesWriter::write_frame(FrameHeader& frame) {
+    if (!Codec::deflate(staging.data(), staging.size(), level, payload)) {
+        throw std::runtime_error("Time series compression failed");
+    }
+    frame.bytes = payload.size();
+    file->write(&frame, sizeof(frame));
+    file->write(payload.data(), payload.size());
+
+    ++m_stats.frames;
+    m_stats.raw_bytes += header.count * sizeof(double);
+    m_stats.stored_bytes += sizeof(frame) + payload.size();
+}
+
+void TimeSeriesWriter::close() {
+    if (file) {
+        std::unique_ptr<FileWriter> closing = std::move(file);
+        closing->close();
+    }
+}
+
+TimeSeriesReader::TimeSeriesReader(const std::string& filename)
+    : filename(filename)
+    , file(filename, std::ios::binary)
+{
+    if (!file.is_open()) {
+        throw std::runtime_error("Impossible to open the file " + filename);
+    }
+    if (!file.read(reinterpret_cast<char*>(&m_header), sizeof(m_header))
+        || std::memcmp(m_header.magic, TimeSeriesHeader::MAGIC, sizeof(m_header.magic)) != 0) {
+        throw std::runtime_error(filename + " is not a time series");
+    }
+    if (m_header.version != TimeSeriesHeader::VERSION) {
+        throw std::runtime_error(filename + ": unsupported time series version " + std::to_string(m_header.version));
+    }
+    if (m_header.endian_check != TimeSeriesHeader::ENDIAN_CHECK) {
+        throw std::runtime_error(filename + ": time series written with another byte order");
+    }
+    if (m_header.count != (m_header.nx + 1) * (m_header.ny + 1) * (m_header.nz + 1)) {
+        throw std::runtime_error(filename + ": inconsistent time series header");
+    }
+
+    file.seekg(0, std::ios::end);
+    const uint64_t size = static_cast<uint64_t>(file.tellg());
+    uint64_t offset = sizeof(m_header);
+    Entry entry;
+    while (offset + sizeof(FrameHeader) <= size) {
+        file.seekg(offset);
+        file.read(reinterpret_cast<char*>(&entry.header), sizeof(FrameHeader));
+        entry.offset = offset + sizeof(FrameHeader);
+        if (!file || entry.header.frame != index.size() || entry.offset + entry.header.bytes > size
+            || (index.empty() && entry.header.type != FrameHeader::KEYFRAME)) {
+            break;
+        }
+        index.push_back(entry);
+        offset = entry.offset + entry.header.bytes;
+    }
+    file.clear();
+    values.resize(m_header.count);
+    decoded = index.size();
+}
+
+/**
+ * @brief Decodes frame n on top of values, which must hold frame n - 1 unless n is a keyframe
+ */
+void TimeSeriesReader::apply(size_t n) {
+    // Une trame interrompue par une exception laisse values incohérent
+    decoded = index.size();
+    const FrameHeader& frame = index[n].header;
+    const size_t count = values.size();
+    stored.resize(frame.bytes);
+    file.seekg(index[n].offset);
+    file.read(reinterpret_cast<char*>(stored.data()), stored.size());
+    if (!file) {
+        throw std::runtime_error("Error while reading the file " + filename);
+    }
+
+    const size_t width = frame.type == FrameHeader::DELTA_QUANT ? sizeof(uint32_t) : sizeof(double);
+    if (frame.outliers > count) {
+        throw std::runtime_error(filename + ": corrupted frame " + std::to_string(n));
+    }
+    staging.resize(count * width + frame.outliers * sizeof(double));
+    if (!Codec::inflate(stored.data(), stored.size(), staging.data(), staging.size())) {
+        throw std::runtime_error(filename + ": corrupted frame " + std::to_string(n));
+    }
+
+    if (frame.type == FrameHeader::KEYFRAME) {
+        Codec::unshuffle(staging.data(), count, sizeof(double), values.data());
+    } else if (frame.type == FrameHeader::DELTA_XOR) {
+        std::vector<uint64_t> bits(count);
+        Codec::unshuffle(staging.data(), count, sizeof(uint64_t), bits.data());
+        for (size_t e = 0; e < count; ++e) {
+            uint64_t a;
+            std::memcpy(&a, &values[e], sizeof(a));
+            a ^= bits[e];
+            std::memcpy(&values[e], &a, sizeof(a));
+        }
+    } else if (frame.type == FrameHeader::DELTA_QUANT) {
+        std::vector<uint32_t> codes(count);
+        Codec::unshuffle(staging.data(), count, sizeof(uint32_t), codes.data());
+        const uint8_t* outliers = staging.data() + count * sizeof(uint32_t);
+        const double step = 2.0 * m_header.error_bound;
+        size_t next = 0;
+        for (size_t e = 0; e < count; ++e) {
+            if (codes[e] == Codec::OUTLIER) {
+                if (next == frame.outliers) {
+                    throw std::runtime_error(filename + ": corrupted frame " + std::to_string(n));
+                }
+                std::memcpy(&values[e], outliers + sizeof(double) * next++, sizeof(double));
+            } else {
+                values[e] += step * static_cast<double>(Codec::unzigzag(codes[e]));
+            }
+        }
+    } else {
+        throw std::runtime_error(filename + ": invalid frame " + std::to_string(n));
+    }
+    decoded = n;
+}
+
+const std::vector<double>& TimeSeriesReader::read(size_t n) {
+    if (n >= index.size()) {
+        throw std::runtime_error(filename + ": no frame " + std::to_string(n));
+    }
+    size_t key = n;
+    while (index[key].header.type != FrameHeader::KEYFRAME) --key;
+
+    // Repart de la dernière trame lue si elle est entre la trame clé et n
+    size_t first = key;
+    if (decoded < index.size() && decoded >= key && decoded <= n) {
+        first = decoded + 1;
+    }
+    for (size_t f = first; f <= n; ++f) {
+        apply(f);
+    }
+    return values;
+}
+
+void TimeSeriesReader::read(size_t n, Solution& solution) {
+    if (solution.size() != m_header.count) {
+        throw std::runtime_error(filename + ": time series size does not match the solution");
+    }
+    const std::vector<double>& frame = read(n);
+    size_t e = 0;
+    for (size_t k = 0; k <= m_header.nz; ++k)
+        for (size_t j = 0; j <= m_header.ny; ++j)
+            for (size_t i = 0; i <= m_header.nx; ++i)
+                solution(i, j, k) = frame[e++];
+}
@@ -0,0 +1,194 @@
+/**
+ * @file time_series.hpp
+ * @brief Temporal delta encoding of consecutive Solution frames in a single file
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ *
+ * A time series stores every keyframe_interval-th frame as a keyframe
+ * (shuffled float64, zlib) and the frames in between as deltas against the
+ * previous frame:
+ * - lossless (error bound 0): XOR of the float64 bit patterns, whose
+ *   leading bytes are zero for small changes;
+ * - lossy: the difference with the previous reconstructed frame quantized
+ *   in steps of twice the bound, so the error never accumulates.
+ *
+ *   offset 0     TimeSeriesHeader (magic "HEATTSR", shape, keyframe interval, bound)
+ *   then         FrameHeader + payload, for each frame in order
+ *
+ * Frames hold the grid points (i, j, k) read through Solution::operator(),
+ * x fastest. A reader reaches any frame by replaying from the nearest
+ * keyframe before it.
+ */
+
+#ifndef TIME_SERIES_HPP
+#define TIME_SERIES_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "file_writer.hpp"
+#include "parameters.hpp"
+#include "solution.hpp"
+
+/**
+ * @struct TimeSeriesHeader
+ * @brief Fixed header at the beginning of a time series
+ */
+struct TimeSeriesHeader {
+    static constexpr char MAGIC[8] = {'H', 'E', 'A', 'T', 'T', 'S', 'R', '\0'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t ENDIAN_CHECK = 0x01020304;
+
+    char magic[8];              ///< "HEATTSR"
+    uint32_t version;           ///< Format version
+    uint32_t endian_check;      ///< ENDIAN_CHECK in the byte order of the writer
+    uint64_t nx, ny, nz;        ///< Subdivisions in each direction
+    uint64_t count;             ///< Values per frame ((nx+1)(ny+1)(nz+1))
+    double dx, dy, dz;          ///< Grid spacing
+    uint64_t keyframe_interval; ///< Frames between keyframes
+    double error_bound;         ///< Absolute error bound of the deltas (0: lossless)
+};
+
+/**
+ * @struct FrameHeader
+ * @brief Header preceding the payload of each frame
+ */
+struct FrameHeader {
+    static constexpr uint32_t KEYFRAME = 0;     ///< Shuffled float64, zlib
+    static constexpr uint32_t DELTA_XOR = 1;    ///< XOR with the previous frame, shuffled, zlib
+    static constexpr uint32_t DELTA_QUANT = 2;  ///< Quantized difference codes then outliers, shuffled, zlib
+
+    uint64_t frame;             ///< Frame number, from 0
+    uint64_t iteration;         ///< Iterations completed
+    double time;                ///< Simulated time
+    uint32_t type;              ///< KEYFRAME, DELTA_XOR or DELTA_QUANT
+    uint32_t reserved;
+    uint64_t outliers;          ///< DELTA_QUANT: values stored exactly
+    uint64_t bytes;             ///< Size of the payload
+};
+
+/**
+ * @struct TimeSeriesStats
+ * @brief Sizes and error of a written time series
+ */
+struct TimeSeriesStats {
+    uint64_t frames = 0;        ///< Frames written
+    uint64_t keyframes = 0;     ///< Of which keyframes
+    uint64_t raw_bytes = 0;     ///< Size of the frames in float64
+    uint64_t stored_bytes = 0;  ///< Size of the file
+    double max_error = 0.0;     ///< Largest absolute error of the reconstructed values
+
+    double ratio() const { return stored_bytes > 0 ? static_cast<double>(raw_bytes) / stored_bytes : 0.0; }
+};
+
+/**
+ * @class TimeSeriesWriter
+ * @brief Appends frames to a time series file
+ */
+class TimeSeriesWriter {
+private:
+    TimeSeriesHeader header;
+    std::unique_ptr<FileWriter> file;
+    int level;
+    std::vector<double> current;        // Valeurs de la trame à écrire
+    std::vector<double> previous;       // Trame précédente telle que le lecteur la reconstruit
+    std::vector<uint8_t> staging;       // Données avant compression
+    std::vector<uint8_t> payload;       // Données compressées
+    TimeSeriesStats m_stats;
+
+public:
+    /**
+     * @brief Creates the file and writes its header
+     * @param filename Path of the file
+     * @param params Parameters of the grid and io_* backend options
+     * @param keyframe_interval Frames between keyframes (1: keyframes only)
+     * @param error_bound Absolute error bound of the deltas (0: lossless)
+     * @param level zlib compression level
+     * @throw std::runtime_error if the file cannot be created
+     */
+    TimeSeriesWriter(const std::string& filename, const Parameters& params,
+                     size_t keyframe_interval = 10, double error_bound = 0.0, int level = 1);
+
+    ~TimeSeriesWriter();
+
+    TimeSeriesWriter(const TimeSeriesWriter&) = delete;
+    TimeSeriesWriter& operator=(const TimeSeriesWriter&) = delete;
+
+    /**
+     * @brief Encodes and appends a frame
+     * @param solution Grid values
+     * @param time Simulated time
+     * @param iteration Iterations completed
+     */
+    void append(const Solution& solution, double time, uint64_t iteration);
+
+    /**
+     * @brief Completes the writes and closes the file
+     */
+    void close();
+
+    const TimeSeriesStats& stats() const { return m_stats; }
+
+private:
+    void write_frame(FrameHeader& frame);
+};
+
+/**
+ * @class TimeSeriesReader
+ * @brief Random access to the frames of a time series
+ */
+class TimeSeriesReader {
+public:
+    /**
+     * @brief Opens a time series and indexes its frames
+     * @throw std::runtime_error if the file is not a valid time series
+     *
+     * A truncated last frame (interrupted run) is ignored.
+     */
+    explicit TimeSeriesReader(const std::string& filename);
+
+    const TimeSeriesHeader& header() const { return m_header; }
+
+    size_t frames() const { return index.size(); }
+
+    /**
+     * @brief Header of a frame (iteration, time, type)
+     */
+    const FrameHeader& frame(size_t n) const { return index.at(n).header; }
+
+    /**
+     * @brief Reconstructs a frame
+     * @param n Frame number
+     * @return count values, x fastest; valid until the next call
+     *
+     * Decodes the nearest keyframe before n and applies the deltas up to n,
+     * starting from the last frame read when it lies on that path.
+     */
+    const std::vector<double>& read(size_t n);
+
+    /**
+     * @brief Reconstructs a frame into a Solution of the same grid
+     */
+    void read(size_t n, Solution& solution);
+
+private:
+    struct Entry {
+        FrameHeader header;
+        uint64_t offset;                // Position de la charge utile
+    };
+
+    std::string filename;
+    std::ifstream file;
+    TimeSeriesHeader m_header;
+    std::vector<Entry> index;
+    std::vector<double> values;         // Dernière trame reconstruite
+    size_t decoded;                     // Son numéro (frames() si aucune)
+    std::vector<uint8_t> stored;
+    std::vector<uint8_t> staging;
+
+    void apply(size_t n);
+};
+
+#endif
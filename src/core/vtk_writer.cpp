@@ -0,0 +1,169 @@
+/**
+ * @file vtk_writer.cpp
+ * @brief Implementation of the VtkWriter class methods
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ */
+
+#include "vtk_writer.hpp"
+#include "file_writer.hpp"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+const char* byte_order() {
+    const uint16_t probe = 1;
+    return *reinterpret_cast<const uint8_t*>(&probe) == 1 ? "LittleEndian" : "BigEndian";
+}
+
+const char* vtk_type(uint32_t precision) {
+    if (precision != 4 && precision != 8) {
+        throw std::runtime_error("VTK precision must be 4 or 8 bytes");
+    }
+    return precision == 8 ? "Float64" : "Float32";
+}
+
+std::string extent(const Parameters& params, size_t k_begin, size_t k_end) {
+    std::ostringstream text;
+    text << "0 " << params.getNx() << " 0 " << params.getNy() << " " << k_begin << " " << k_end;
+    return text.str();
+}
+
+std::string spacing(const Parameters& params) {
+    std::ostringstream text;
+    text.precision(17);
+    text << params.getDx() << " " << params.getDy() << " " << params.getDz();
+    return text.str();
+}
+
+/**
+ * @brief Appends the values of a row of planes, converted to the output precision
+ */
+template <typename T>
+void gather_plane(const Solution& solution, size_t nx, size_t ny, size_t k, std::vector<T>& plane) {
+    plane.resize((nx + 1) * (ny + 1));
+    size_t index = 0;
+    for (size_t j = 0; j <= ny; ++j) {
+        for (size_t i = 0; i <= nx; ++i) {
+            plane[index++] = static_cast<T>(solution(i, j, k));
+        }
+    }
+}
+
+template <typename T>
+void write_planes(FileWriter& file, const Solution& solution, size_t nx, size_t ny, size_t k_begin, size_t k_end) {
+    std::vector<T> plane;
+    for (size_t k = k_begin; k <= k_end; ++k) {
+        gather_plane(solution, nx, ny, k, plane);
+        file.write(plane.data(), plane.size() * sizeof(T));
+    }
+}
+
+}  // namespace
+
+void VtkWriter::write_vti(const std::string& filename, const Solution& solution, const Parameters& params,
+                          double time, uint32_t precision) {
+    write_piece(filename, solution, params, time, 0, params.getNz(), precision);
+}
+
+/**
+ * @brief Implementation of a piece writer
+ *
+ * XML header with a single appended DataArray at offset 0, then "_", the
+ * UInt64 byte count and the values plane by plane. Values are read through
+ * Solution::operator() so the file shows the grid as the solver indexes it.
+ */
+void VtkWriter::write_piece(const std::string& filename, const Solution& solution, const Parameters& params,
+                            double time, size_t k_begin, size_t k_end, uint32_t precision) {
+    const char* type = vtk_type(precision);
+    const size_t nx = params.getNx();
+    const size_t ny = params.getNy();
+    const std::string piece_extent = extent(params, k_begin, k_end);
+
+    std::ostringstream header;
+    header.precision(17);
+    header << "<?xml version=\"1.0\"?>\n"
+           << "<VTKFile type=\"ImageData\" version=\"1.0\" byte_order=\"" << byte_order() << "\" header_type=\"UInt64\">\n"
+           << "  <ImageData WholeExtent=\"" << extent(params, 0, params.getNz()) << "\" Origin=\"0 0 0\" Spacing=\"" << spacing(params) << "\">\n"
+           << "    <FieldData>\n"
+           << "      <DataArray type=\"Float64\" Name=\"TimeValue\" NumberOfTuples=\"1\" format=\"ascii\">" << time << "</DataArray>\n"
+           << "    </FieldData>\n"
+           << "    <Piece Extent=\"" << piece_extent << "\">\n"
+           << "      <PointData Scalars=\"temperature\">\n"
+           << "        <DataArray type=\"" << type << "\" Name=\"temperature\" format=\"appended\" offset=\"0\"/>\n"
+           << "      </PointData>\n"
+           << "    </Piece>\n"
+           << "  </ImageData>\n"
+           << "  <AppendedData encoding=\"raw\">\n_";
+
+    const uint64_t bytes = static_cast<uint64_t>(nx + 1) * (ny + 1) * (k_end - k_begin + 1) * precision;
+    const std::string prologue = header.str();
+    const std::string epilogue = "\n  </AppendedData>\n</VTKFile>\n";
+
+    std::unique_ptr<FileWriter> file = FileWriter::open(filename, IoOptions::from_parameters(params));
+    file->write(prologue.data(), prologue.size());
+    file->write(&bytes, sizeof(bytes));
+    if (precision == 8) {
+        write_planes<double>(*file, solution, nx, ny, k_begin, k_end);
+    } else {
+        write_planes<float>(*file, solution, nx, ny, k_begin, k_end);
+    }
+    file->write(epilogue.data(), epilogue.size());
+    file->close();
+}
+
+/**
+ * @brief Implementation of the parallel writer
+ *
+ * Consecutive pieces share their boundary plane, as VTK extents are
+ * inclusive. Each worker of the pool writes its own pieces; the .pvti
+ * index is written last, once every piece exists.
+ */
+void VtkWriter::write_pvti(const std::string& filename, const Solution& solution, const Parameters& params,
+                           double time, ThreadPool& pool, size_t pieces, uint32_t precision) {
+    const char* type = vtk_type(precision);
+    const size_t nz = params.getNz();
+    pieces = std::max<size_t>(1, std::min(pieces, nz));
+
+    const size_t slash = filename.find_last_of('/');
+    const std::string directory = slash == std::string::npos ? "" : filename.substr(0, slash + 1);
+    std::string stem = slash == std::string::npos ? filename : filename.substr(slash + 1);
+    if (stem.size() > 5 && stem.compare(stem.size() - 5, 5, ".pvti") == 0) stem.resize(stem.size() - 5);
+
+    std::vector<std::string> sources(pieces);
+    std::vector<std::pair<size_t, size_t>> slabs(pieces);
+    for (size_t p = 0; p < pieces; ++p) {
+        sources[p] = stem + "_" + std::to_string(p) + ".vti";
+        slabs[p] = {nz * p / pieces, nz * (p + 1) / pieces};
+    }
+
+    pool.parallel_for(0, pieces, [&](size_t first, size_t last, size_t) {
+        for (size_t p = first; p < last; ++p) {
+            write_piece(directory + sources[p], solution, params, time, slabs[p].first, slabs[p].second, precision);
+        }
+    }, "VTK pieces", 1);
+
+    std::ofstream index(filename);
+    if (!index.is_open()) {
+        throw std::runtime_error("Impossible to open the file " + filename);
+    }
+    index.precision(17);
+    index << "<?xml version=\"1.0\"?>\n"
+          << "<VTKFile type=\"PImageData\" version=\"1.0\" byte_order=\"" << byte_order() << "\" header_type=\"UInt64\">\n"
+          << "  <PImageData WholeExtent=\"" << extent(params, 0, nz) << "\" GhostLevel=\"0\" Origin=\"0 0 0\" Spacing=\"" << spacing(params) << "\">\n"
+          << "    <PPointData Scalars=\"temperature\">\n"
+          << "      <PDataArray type=\"" << type << "\" Name=\"temperature\"/>\n"
+          << "    </PPointData>\n";
+    for (size_t p = 0; p < pieces; ++p) {
+        index << "    <Piece Extent=\"" << extent(params, slabs[p].first, slabs[p].second) << "\" Source=\"" << sources[p] << "\"/>\n";
+    }
+    index << "  </PImageData>\n"
+          << "</VTKFile>\n";
+    if (!index) {
+        throw std::runtime_error("Error while writing the file " + filename);
+    }
+}
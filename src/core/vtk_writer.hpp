@@ -0,0 +1,62 @@
+/**
+ * @file vtk_writer.hpp
+ * @brief VTK ImageData (.vti / .pvti) output of Solution for ParaView
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ *
+ * The values are stored as appended raw binary (UInt64 size header then
+ * the values, x fastest), so writing a grid costs a gather of its rows
+ * and not a text conversion. A .pvti splits the grid in slabs of
+ * z-planes, one .vti piece per slab, written in parallel.
+ */
+
+#ifndef VTK_WRITER_HPP
+#define VTK_WRITER_HPP
+
+#include <cstdint>
+#include <string>
+#include "parameters.hpp"
+#include "solution.hpp"
+#include "thread_pool.hpp"
+
+/**
+ * @class VtkWriter
+ * @brief Writes Solution as VTK XML ImageData
+ */
+class VtkWriter {
+public:
+    /**
+     * @brief Writes the whole grid as a single .vti file
+     * @param filename Path of the .vti file
+     * @param solution Grid values
+     * @param params Parameters of the grid
+     * @param time Simulated time, stored as TimeValue field data
+     * @param precision 8 (Float64) or 4 (Float32)
+     * @throw std::runtime_error if the file cannot be written
+     */
+    static void write_vti(const std::string& filename, const Solution& solution, const Parameters& params,
+                          double time, uint32_t precision = 8);
+
+    /**
+     * @brief Writes the grid as a .pvti file and one .vti piece per slab of z-planes
+     * @param filename Path of the .pvti file; pieces are named <stem>_<piece>.vti beside it
+     * @param solution Grid values
+     * @param params Parameters of the grid
+     * @param time Simulated time
+     * @param pool Threads writing the pieces
+     * @param pieces Number of slabs (at most nz)
+     * @param precision 8 (Float64) or 4 (Float32)
+     * @throw std::runtime_error if a file cannot be written
+     */
+    static void write_pvti(const std::string& filename, const Solution& solution, const Parameters& params,
+                           double time, ThreadPool& pool, size_t pieces, uint32_t precision = 8);
+
+private:
+    /**
+     * @brief Writes the planes [k_begin, k_end] (inclusive, as VTK extents) as a .vti file
+     */
+    static void write_piece(const std::string& filename, const Solution& solution, const Parameters& params,
+                            double time, size_t k_begin, size_t k_end, uint32_t precision);
+};
+
+#endif
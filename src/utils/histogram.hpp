@@ -0,0 +1,121 @@
+/**
+ * @file histogram.hpp
+ * @brief Log-bucketed latency histogram with percentile queries
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ *
+ * This utility provides a fixed-size, allocation-free histogram in the
+ * spirit of HDR histograms: values are binned in power-of-two magnitudes,
+ * each split into linear sub-buckets, so that any recorded latency is known
+ * within a bounded relative error (1/16 here) from nanoseconds to hours.
+ */
+#pragma once
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <limits>
+
+/**
+ * @class LatencyHistogram
+ * @brief Records nanosecond latencies in logarithmic buckets
+ *
+ * Recording is O(1) and never allocates, so it can be called on every
+ * iteration of the solver. Percentiles are obtained by a linear scan of
+ * the buckets and are reported as the upper bound of the bucket holding
+ * the requested rank (clamped to the true maximum).
+ */
+class LatencyHistogram {
+public:
+    static constexpr int sub_bucket_bits = 4;                                 ///< log2 of the linear sub-buckets per magnitude
+    static constexpr uint64_t sub_bucket_count = 1ull << sub_bucket_bits;     ///< Linear sub-buckets per magnitude
+    static constexpr size_t bucket_count = (64 - sub_bucket_bits + 1) * sub_bucket_count;  ///< Total number of buckets
+
+    /**
+     * @brief Default constructor
+     * Creates an empty histogram
+     */
+    LatencyHistogram() { reset(); }
+
+    /**
+     * @brief Clears all recorded values
+     */
+    void reset() {
+        m_buckets.fill(0);
+        m_count = 0;
+        m_sum = 0;
+        m_min = std::numeric_limits<uint64_t>::max();
+        m_max = 0;
+    }
+
+    /**
+     * @brief Records one value
+     * @param value_ns The latency to record, in nanoseconds
+     */
+    void record(uint64_t value_ns) {
+        ++m_buckets[bucket_index(value_ns)];
+        ++m_count;
+        m_sum += value_ns;
+        m_min = std::min(m_min, value_ns);
+        m_max = std::max(m_max, value_ns);
+    }
+
+    /**
+     * @brief Gets the value at a given percentile
+     * @param percentile Percentile in [0, 100]
+     * @return The latency in nanoseconds below which the given fraction of samples falls (0 if empty)
+     */
+    uint64_t percentile(double percentile) const {
+        if (m_count == 0) return 0;
+        percentile = std::min(std::max(percentile, 0.0), 100.0);
+        uint64_t rank = static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(m_count) + 0.5);
+        rank = std::max<uint64_t>(rank, 1);
+
+        uint64_t cumulated = 0;
+        for (size_t i = 0; i < bucket_count; ++i) {
+            cumulated += m_buckets[i];
+            if (cumulated >= rank) {
+                return std::min(std::max(bucket_upper_bound(i), m_min), m_max);
+            }
+        }
+        return m_max;
+    }
+
+    uint64_t count() const { return m_count; }
+    uint64_t min() const { return m_count ? m_min : 0; }
+    uint64_t max() const { return m_max; }
+    double mean() const { return m_count ? static_cast<double>(m_sum) / m_count : 0.0; }
+
+private:
+    /**
+     * @brief Maps a value to its bucket
+     *
+     * Values below sub_bucket_count are stored exactly. Above, the value
+     * v with most significant bit m lands in magnitude (m - sub_bucket_bits + 1)
+     * and sub-bucket given by the next sub_bucket_bits bits of v.
+     */
+    static size_t bucket_index(uint64_t value) {
+        if (value < sub_bucket_count) return static_cast<size_t>(value);
+        const int msb = 63 - __builtin_clzll(value);
+        const int shift = msb - sub_bucket_bits;
+        const uint64_t sub = (value >> shift) - sub_bucket_count;
+        return static_cast<size_t>((shift + 1) * sub_bucket_count + sub);
+    }
+
+    /**
+     * @brief Largest value that maps to the given bucket
+     */
+    static uint64_t bucket_upper_bound(size_t index) {
+        if (index < sub_bucket_count) return index;
+        const int shift = static_cast<int>(index / sub_bucket_count) - 1;
+        const uint64_t sub = index % sub_bucket_count;
+        const uint64_t lower = (sub_bucket_count + sub) << shift;
+        return lower + ((1ull << shift) - 1);
+    }
+
+    std::array<uint64_t, bucket_count> m_buckets;  ///< Per-bucket sample counts
+    uint64_t m_count;                               ///< Number of recorded samples
+    uint64_t m_sum;                                 ///< Sum of recorded values (ns)
+    uint64_t m_min;                                 ///< Smallest recorded value (ns)
+    uint64_t m_max;                                 ///< Largest recorded value (ns)
+};
@@ -0,0 +1,242 @@
+/**
+ * @file memory_tracker.hpp
+ * @brief Attribution of the large allocations of the solver to named owners
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ *
+ * This utility keeps, for each named owner (U_current, U_next, GPU
+ * buffers, output staging buffers, ...), the bytes currently held, the
+ * peak and the number of allocations, and samples the resident set size
+ * of the process. It does not hook the global allocator: owners report
+ * their large buffers explicitly, which is enough to explain which
+ * allocation pushed a run over the memory limit.
+ */
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+/**
+ * @class MemoryTracker
+ * @brief Process-wide ledger of tracked allocations
+ */
+class MemoryTracker {
+public:
+    /**
+     * @struct Usage
+     * @brief Bytes attributed to one owner
+     */
+    struct Usage {
+        size_t current = 0;         ///< Bytes currently held
+        size_t peak = 0;            ///< Largest value of current
+        uint64_t allocations = 0;   ///< Number of allocate() calls
+    };
+
+    /**
+     * @class Allocation
+     * @brief RAII handle that attributes a buffer to an owner for its lifetime
+     *
+     * Copies attribute the same number of bytes again, moves transfer them.
+     */
+    class Allocation {
+    public:
+        Allocation() = default;
+        Allocation(const std::string& owner, size_t bytes) : m_owner(owner), m_bytes(bytes) {
+            MemoryTracker::instance().allocate(m_owner, m_bytes);
+        }
+        Allocation(const Allocation& other) : Allocation(other.m_owner, other.m_bytes) {}
+        Allocation(Allocation&& other) noexcept : m_owner(std::move(other.m_owner)), m_bytes(other.m_bytes) {
+            other.m_bytes = 0;
+        }
+        Allocation& operator=(Allocation other) noexcept {
+            std::swap(m_owner, other.m_owner);
+            std::swap(m_bytes, other.m_bytes);
+            return *this;
+        }
+        ~Allocation() {
+            if (m_bytes > 0) MemoryTracker::instance().release(m_owner, m_bytes);
+        }
+
+        size_t bytes() const { return m_bytes; }
+
+    private:
+        std::string m_owner;    ///< Owner the bytes are attributed to
+        size_t m_bytes = 0;     ///< Attributed bytes
+    };
+
+    /**
+     * @brief Gets the process-wide tracker
+     */
+    static MemoryTracker& instance() {
+        static MemoryTracker tracker;
+        return tracker;
+    }
+
+    /**
+     * @brief Attributes bytes to an owner
+     * @param owner Name displayed in the summary
+     * @param bytes Size of the allocation
+     */
+    void allocate(const std::string& owner, size_t bytes) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Usage& usage = m_owners[owner];
+        usage.current += bytes;
+        usage.peak = std::max(usage.peak, usage.current);
+        ++usage.allocations;
+        m_current += bytes;
+        m_peak = std::max(m_peak, m_current);
+        if (m_verbose) log('+', owner, bytes);
+    }
+
+    /**
+     * @brief Releases bytes previously attributed to an owner
+     * @param owner Name given to allocate()
+     * @param bytes Size of the released allocation
+     */
+    void release(const std::string& owner, size_t bytes) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Usage& usage = m_owners[owner];
+        bytes = std::min(bytes, usage.current);
+        usage.current -= bytes;
+        m_current -= std::min(bytes, m_current);
+        if (m_verbose) log('-', owner, bytes);
+    }
+
+    /**
+     * @brief Prints every allocation and release to standard error
+     *
+     * When enabled, the owners already holding memory are logged first.
+     */
+    void set_verbose(bool verbose) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (verbose && !m_verbose) {
+            for (const auto& owner : m_owners) {
+                if (owner.second.current > 0) log('+', owner.first, owner.second.current);
+            }
+        }
+        m_verbose = verbose;
+    }
+
+    std::map<std::string, Usage> owners() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_owners;
+    }
+
+    size_t current() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_current;
+    }
+
+    size_t peak() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_peak;
+    }
+
+    /**
+     * @brief Current resident set size of the process
+     * @return Bytes, or 0 where /proc is not available
+     */
+    static size_t current_rss() {
+        return read_proc_status("VmRSS:");
+    }
+
+    /**
+     * @brief Peak resident set size of the process
+     * @return Bytes (VmHWM from /proc, or getrusage elsewhere)
+     */
+    static size_t peak_rss() {
+        const size_t from_proc = read_proc_status("VmHWM:");
+        if (from_proc > 0) return from_proc;
+#if defined(__unix__) || defined(__APPLE__)
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+            return static_cast<size_t>(usage.ru_maxrss);          // bytes on macOS
+#else
+            return static_cast<size_t>(usage.ru_maxrss) * 1024;   // kilobytes on Linux
+#endif
+        }
+#endif
+        return 0;
+    }
+
+    /**
+     * @brief Formats a byte count with a binary unit
+     */
+    static std::string format_bytes(size_t bytes) {
+        const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+        double value = static_cast<double>(bytes);
+        size_t unit = 0;
+        while (value >= 1024.0 && unit < 4) {
+            value /= 1024.0;
+            ++unit;
+        }
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << value << " " << units[unit];
+        return text.str();
+    }
+
+    /**
+     * @brief Displays the memory breakdown per owner and the process RSS
+     */
+    void display() const {
+        const size_t inner_width = 79;
+        const auto snapshot = owners();
+
+        std::cout << "|" << std::left << std::setw(inner_width) << " Memory" << "|\n"
+                  << "+" << std::string(inner_width, '-') << "+\n"
+                  << "| " << std::left << std::setw(28) << "Owner" << std::right
+                  << std::setw(16) << "current" << std::setw(16) << "peak" << std::setw(17) << "allocations" << " |\n";
+        for (const auto& owner : snapshot) {
+            std::cout << "| " << std::left << std::setw(28) << owner.first.substr(0, 28) << std::right
+                      << std::setw(16) << format_bytes(owner.second.current)
+                      << std::setw(16) << format_bytes(owner.second.peak)
+                      << std::setw(17) << owner.second.allocations << " |\n";
+        }
+        std::cout << "| " << std::left << std::setw(28) << "Tracked total" << std::right
+                  << std::setw(16) << format_bytes(current()) << std::setw(16) << format_bytes(peak())
+                  << std::setw(17) << "" << " |\n"
+                  << "| " << std::left << std::setw(28) << "Process RSS" << std::right
+                  << std::setw(16) << format_bytes(current_rss()) << std::setw(16) << format_bytes(peak_rss())
+                  << std::setw(17) << "" << " |\n"
+                  << "+" << std::string(inner_width, '-') << "+\n";
+    }
+
+private:
+    MemoryTracker() = default;
+
+    static size_t read_proc_status(const std::string& key) {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.rfind(key, 0) == 0) {
+                std::istringstream fields(line.substr(key.size()));
+                size_t kilobytes = 0;
+                fields >> kilobytes;
+                return kilobytes * 1024;
+            }
+        }
+        return 0;
+    }
+
+    void log(char sign, const std::string& owner, size_t bytes) const {
+        std::cerr << "[memory] " << sign << format_bytes(bytes) << " " << owner
+                  << " (tracked " << format_bytes(m_current) << ", RSS " << format_bytes(current_rss()) << ")\n";
+    }
+
+    mutable std::mutex m_mutex;                 ///< Guards the ledger
+    std::map<std::string, Usage> m_owners;      ///< Usage per owner
+    size_t m_current = 0;                       ///< Bytes currently tracked
+    size_t m_peak = 0;                          ///< Peak of m_current
+    bool m_verbose = false;                     ///< Log every event
+};
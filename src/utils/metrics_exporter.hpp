@@ -0,0 +1,237 @@
+/**
+ * @file metrics_exporter.hpp
+ * @brief Live metrics of a running simulation in the Prometheus text format
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ *
+ * This utility exposes the progress of the solver (iteration, simulated
+ * time, variation, step latency percentiles, MLUPS and memory) while it
+ * runs, either over a local HTTP socket (GET on any path returns the
+ * metrics) or as a file rewritten periodically with an atomic rename.
+ *
+ * The solver only stores values in atomics (publish); formatting, the
+ * socket and the file are handled by a background thread, so the time
+ * loop never waits on a scraper.
+ */
+#pragma once
+#include "memory_tracker.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/**
+ * @struct MetricsSnapshot
+ * @brief Values published by the solver
+ */
+struct MetricsSnapshot {
+    uint64_t iteration = 0;         ///< Last completed iteration
+    uint64_t max_iterations = 0;    ///< Iterations of the run
+    double simulated_time = 0.0;    ///< Simulated time (s)
+    double variation = 0.0;         ///< Variation of the last step
+    double step_p50 = 0.0;          ///< Median step latency (s)
+    double step_p90 = 0.0;          ///< 90th percentile step latency (s)
+    double step_p99 = 0.0;          ///< 99th percentile step latency (s)
+    double mlups = 0.0;             ///< Million lattice updates per second since the start
+};
+
+/**
+ * @class MetricsExporter
+ * @brief Background thread serving the last published snapshot
+ */
+class MetricsExporter {
+public:
+    /**
+     * @brief Starts the exporter thread
+     * @param port Local TCP port of the HTTP endpoint (0 to disable)
+     * @param file File rewritten every interval (empty to disable)
+     * @param interval Period of the file rewrite, and polling period of the thread
+     * @throw std::runtime_error if the port cannot be bound
+     */
+    MetricsExporter(int port, const std::string& file, std::chrono::milliseconds interval)
+        : m_file(file), m_interval(interval), m_socket(-1), m_stop(false) {
+        if (port > 0) {
+            m_socket = open_socket(port);
+        }
+        m_thread = std::thread(&MetricsExporter::serve, this);
+    }
+
+    ~MetricsExporter() {
+        m_stop.store(true);
+        if (m_thread.joinable()) m_thread.join();
+        if (m_socket >= 0) ::close(m_socket);
+    }
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    /**
+     * @brief Publishes new values (a few relaxed atomic stores, never blocks)
+     */
+    void publish(const MetricsSnapshot& snapshot) {
+        m_iteration.store(snapshot.iteration, std::memory_order_relaxed);
+        m_maxIterations.store(snapshot.max_iterations, std::memory_order_relaxed);
+        m_simulatedTime.store(snapshot.simulated_time, std::memory_order_relaxed);
+        m_variation.store(snapshot.variation, std::memory_order_relaxed);
+        m_stepP50.store(snapshot.step_p50, std::memory_order_relaxed);
+        m_stepP90.store(snapshot.step_p90, std::memory_order_relaxed);
+        m_stepP99.store(snapshot.step_p99, std::memory_order_relaxed);
+        m_mlups.store(snapshot.mlups, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Formats the current values in the Prometheus text format
+     */
+    std::string render() const {
+        std::ostringstream out;
+        out.precision(9);
+        auto metric = [&out](const char* name, const char* type, const char* help, double value) {
+            out << "# HELP " << name << " " << help << "\n"
+                << "# TYPE " << name << " " << type << "\n"
+                << name << " " << value << "\n";
+        };
+        metric("heat_iteration", "counter", "Last completed iteration.",
+               static_cast<double>(m_iteration.load(std::memory_order_relaxed)));
+        metric("heat_max_iterations", "gauge", "Iterations of the run.",
+               static_cast<double>(m_maxIterations.load(std::memory_order_relaxed)));
+        metric("heat_simulated_time_seconds", "gauge", "Simulated time.",
+               m_simulatedTime.load(std::memory_order_relaxed));
+        metric("heat_variation", "gauge", "Variation of the last time step.",
+               m_variation.load(std::memory_order_relaxed));
+        out << "# HELP heat_step_latency_seconds Latency of the time steps.\n"
+            << "# TYPE heat_step_latency_seconds summary\n"
+            << "heat_step_latency_seconds{quantile=\"0.5\"} " << m_stepP50.load(std::memory_order_relaxed) << "\n"
+            << "heat_step_latency_seconds{quantile=\"0.9\"} " << m_stepP90.load(std::memory_order_relaxed) << "\n"
+            << "heat_step_latency_seconds{quantile=\"0.99\"} " << m_stepP99.load(std::memory_order_relaxed) << "\n";
+        metric("heat_mlups", "gauge", "Million lattice updates per second since the start.",
+               m_mlups.load(std::memory_order_relaxed));
+        metric("heat_memory_tracked_bytes", "gauge", "Bytes held by the tracked buffers.",
+               static_cast<double>(MemoryTracker::instance().current()));
+        metric("heat_memory_rss_bytes", "gauge", "Resident set size of the process.",
+               static_cast<double>(MemoryTracker::current_rss()));
+        metric("heat_memory_peak_rss_bytes", "gauge", "Peak resident set size of the process.",
+               static_cast<double>(MemoryTracker::peak_rss()));
+        return out.str();
+    }
+
+private:
+    static int open_socket(int port) {
+        const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) {
+            throw std::runtime_error("Impossible to create the metrics socket: " + std::string(std::strerror(errno)));
+        }
+        const int reuse = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);  // Jamais exposé hors de la machine
+        address.sin_port = htons(static_cast<uint16_t>(port));
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || ::listen(fd, 4) < 0) {
+            const std::string reason = std::strerror(errno);
+            ::close(fd);
+            throw std::runtime_error("Impossible to bind the metrics port " + std::to_string(port) + ": " + reason);
+        }
+        return fd;
+    }
+
+    /**
+     * @brief Thread body: answers scrapers and rewrites the file until stopped
+     */
+    void serve() {
+        // Attente bornée pour que l'arrêt ne dépende pas de la période
+        const auto wait = std::min(m_interval, std::chrono::milliseconds(100));
+        auto last_write = std::chrono::steady_clock::now() - m_interval;
+        while (!m_stop.load()) {
+            if (m_socket >= 0) {
+                pollfd listener{m_socket, POLLIN, 0};
+                if (::poll(&listener, 1, static_cast<int>(wait.count())) > 0 && (listener.revents & POLLIN)) {
+                    answer(::accept(m_socket, nullptr, nullptr));
+                }
+            } else {
+                std::this_thread::sleep_for(wait);
+            }
+            if (!m_file.empty() && std::chrono::steady_clock::now() - last_write >= m_interval) {
+                write_file();
+                last_write = std::chrono::steady_clock::now();
+            }
+        }
+        if (!m_file.empty()) write_file();  // Valeurs finales
+    }
+
+#ifdef MSG_NOSIGNAL
+    static constexpr int SEND_FLAGS = MSG_NOSIGNAL;  // Linux : pas de SIGPIPE si le client est parti
+#else
+    static constexpr int SEND_FLAGS = 0;
+#endif
+
+    void answer(int client) const {
+        if (client < 0) return;
+#ifdef SO_NOSIGPIPE
+        // Un client parti pendant l'envoi donne EPIPE au lieu de SIGPIPE (macOS)
+        int nosigpipe = 1;
+        ::setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &nosigpipe, sizeof(nosigpipe));
+#endif
+        char request[1024];
+        pollfd readable{client, POLLIN, 0};
+        if (::poll(&readable, 1, 1000) > 0) {
+            (void)::recv(client, request, sizeof(request), 0);  // Requête ignorée: une seule ressource
+        }
+        const std::string body = render();
+        const std::string response = "HTTP/1.0 200 OK\r\n"
+                                     "Content-Type: text/plain; version=0.0.4\r\n"
+                                     "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                                     "Connection: close\r\n\r\n" + body;
+        size_t sent = 0;
+        while (sent < response.size()) {
+            const ssize_t n = ::send(client, response.data() + sent, response.size() - sent, SEND_FLAGS);
+            if (n <= 0) break;
+            sent += static_cast<size_t>(n);
+        }
+        ::close(client);
+    }
+
+    /**
+     * @brief Writes a temporary file and renames it, so readers never see a partial file
+     */
+    void write_file() const {
+        const std::string temporary = m_file + ".tmp";
+        {
+            std::ofstream file(temporary);
+            if (!file.is_open()) return;  // Réessayé à la prochaine période
+            file << render();
+        }
+        std::rename(temporary.c_str(), m_file.c_str());
+    }
+
+    std::string m_file;                         ///< File rewritten periodically (optional)
+    std::chrono::milliseconds m_interval;       ///< Period of the file rewrite
+    int m_socket;                               ///< Listening socket (-1 if disabled)
+    std::atomic<bool> m_stop;                   ///< Asks the thread to exit
+    std::thread m_thread;                       ///< Exporter thread
+
+    std::atomic<uint64_t> m_iteration{0};
+    std::atomic<uint64_t> m_maxIterations{0};
+    std::atomic<double> m_simulatedTime{0.0};
+    std::atomic<double> m_variation{0.0};
+    std::atomic<double> m_stepP50{0.0};
+    std::atomic<double> m_stepP90{0.0};
+    std::atomic<double> m_stepP99{0.0};
+    std::atomic<double> m_mlups{0.0};
+};
@@ -13,8 +13,10 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <iomanip>
 #include <map>
 #include <cmath>
+#include <stdexcept>
 
 
 
@@ -111,6 +113,45 @@ public:
             }
         }
 
+        parseValues();
+    }
+
+    /**
+     * @brief Overrides a parameter after loading
+     * @param key Name of the parameter (e.g. "nx", "dt")
+     * @param value New raw value
+     * @throw std::runtime_error if the resulting parameters are invalid
+     *
+     * Derived quantities (n_tot, T, spatial steps) are recomputed and the
+     * CFL condition is checked again, so drivers can sweep grid sizes
+     * from a single configuration file.
+     */
+    void set(const std::string& key, const std::string& value) {
+        set({{key, value}});
+    }
+
+    /**
+     * @brief Overrides several parameters at once
+     * @param values Names and new raw values of the parameters
+     * @throw std::runtime_error if the resulting parameters are invalid
+     *
+     * The CFL condition is only checked once all values are applied.
+     */
+    void set(const std::map<std::string, std::string>& values) {
+        for (const auto& value : values) {
+            params[value.first] = value.second;
+        }
+        parseValues();
+        computeSpatialSteps();
+        checkCFLCondition();
+    }
+
+private:
+    /**
+     * @brief Converts the raw values of the mandatory parameters
+     * @throw std::runtime_error if a parameter is missing or invalid
+     */
+    void parseValues() {
         try {
             n_x = std::stoi(params["nx"]);
             n_y = std::stoi(params["ny"]);
@@ -125,6 +166,7 @@ public:
         }
     }
 
+public:
     // Getters existants
     const size_t getNx() const { return n_x; }
     const size_t getNy() const { return n_y; }
@@ -134,6 +176,55 @@ public:
     int getMaxIterations() const { return max_iterations; }
     int getOutputFrequency() const { return output_frequency; }
 
+    /**
+     * @brief Checks whether an optional parameter is set in the file
+     * @param key Name of the parameter
+     * @return true if the key is present with a non-empty value
+     */
+    bool has(const std::string& key) const {
+        auto it = params.find(key);
+        return it != params.end() && !it->second.empty();
+    }
+
+    /**
+     * @brief Gets an optional parameter as a string
+     * @param key Name of the parameter
+     * @param fallback Value returned when the key is absent
+     */
+    std::string getString(const std::string& key, const std::string& fallback) const {
+        return has(key) ? params.at(key) : fallback;
+    }
+
+    /**
+     * @brief Gets an optional parameter as an integer
+     * @param key Name of the parameter
+     * @param fallback Value returned when the key is absent
+     * @throw std::runtime_error if the value is not an integer
+     */
+    long getInt(const std::string& key, long fallback) const {
+        if (!has(key)) return fallback;
+        try {
+            return std::stol(params.at(key));
+        } catch (const std::exception& e) {
+            throw std::runtime_error("Error while parsing parameter " + key + ": " + std::string(e.what()));
+        }
+    }
+
+    /**
+     * @brief Gets an optional parameter as a floating-point value
+     * @param key Name of the parameter
+     * @param fallback Value returned when the key is absent
+     * @throw std::runtime_error if the value is not a number
+     */
+    double getDouble(const std::string& key, double fallback) const {
+        if (!has(key)) return fallback;
+        try {
+            return std::stod(params.at(key));
+        } catch (const std::exception& e) {
+            throw std::runtime_error("Error while parsing parameter " + key + ": " + std::string(e.what()));
+        }
+    }
+
     // Nouveaux getters
     double getDx() const { return dx; }
     double getDx2() const { return dx2; }
@@ -0,0 +1,224 @@
+/**
+ * @file perf_counters.hpp
+ * @brief Hardware performance counters attached to timer scopes
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ *
+ * This utility opens a small set of hardware counters with Linux
+ * perf_event_open (cycles, instructions, last-level cache misses, data TLB
+ * misses and floating-point operations) on the calling thread, and on the
+ * worker threads that attach to it. Timers read the sum over all these
+ * threads at start/stop so that each scope accumulates its own counts.
+ *
+ * Counters that cannot be opened (other platforms, virtual machines,
+ * restrictive perf_event_paranoid, non-Intel CPUs for the FP events) are
+ * simply reported as unavailable; the solver never fails because of them.
+ */
+#pragma once
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @class PerfCounters
+ * @brief Process-wide set of hardware counters for the solver thread and its workers
+ */
+class PerfCounters {
+public:
+    /**
+     * @brief Counted hardware events
+     *
+     * FP_OPS is the weighted sum of the scalar, 128-bit and 256-bit packed
+     * double-precision FP_ARITH_INST_RETIRED events (Intel only).
+     */
+    enum Event { CYCLES = 0, INSTRUCTIONS, LLC_MISSES, DTLB_MISSES, FP_OPS, EVENT_COUNT };
+
+    /**
+     * @struct Sample
+     * @brief Counter values, either a raw reading or an accumulated delta
+     */
+    struct Sample {
+        std::array<uint64_t, EVENT_COUNT> values{};
+
+        Sample& operator+=(const Sample& other) {
+            for (size_t i = 0; i < EVENT_COUNT; ++i) values[i] += other.values[i];
+            return *this;
+        }
+    };
+
+    /**
+     * @brief Gets the process-wide collector
+     */
+    static PerfCounters& instance() {
+        static PerfCounters counters;
+        return counters;
+    }
+
+    /**
+     * @brief Opens the counters on the calling thread
+     * @return true if at least one counter could be opened
+     *
+     * Must be called from the thread that runs the measured scopes.
+     * The reason of a failure is available through status().
+     */
+    bool enable() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_enabled) return true;
+#ifdef __linux__
+        m_fds.push_back(open_thread());
+        for (size_t e = 0; e < EVENT_COUNT; ++e) {
+            m_available[e] = m_fds[0][e][0] >= 0;
+            m_enabled = m_enabled || m_available[e];
+        }
+        if (m_enabled) {
+            m_status = "ok";
+        } else {
+            m_status = "perf_event_open: " + std::string(std::strerror(m_errno));
+            if (m_errno == EACCES || m_errno == EPERM) m_status += " (see perf_event_paranoid)";
+        }
+#else
+        m_status = "hardware counters require Linux perf_event_open";
+#endif
+        return m_enabled;
+    }
+
+    /**
+     * @brief Opens the counters on the calling thread too; read() sums them with the others
+     *
+     * For the workers that run part of the measured scopes. Must be called
+     * after enable() and before the first reading.
+     */
+    void attach_thread() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_enabled) return;
+#ifdef __linux__
+        m_fds.push_back(open_thread());
+#endif
+    }
+
+    bool enabled() const { return m_enabled; }
+    size_t threads() const { return m_fds.size(); }   ///< Threads whose counters are summed
+    bool available(Event event) const { return m_available[event]; }
+    const std::string& status() const { return m_status; }
+
+    /**
+     * @brief Reads the current counter values
+     * @return Counts since enable(), scaled when the kernel multiplexed the counters
+     */
+    Sample read() const {
+        Sample sample;
+#ifdef __linux__
+        static const uint64_t fp_weights[fds_per_event] = {1, 2, 4};
+        for (const ThreadFds& fds : m_fds) {
+            for (size_t e = 0; e < EVENT_COUNT; ++e) {
+                for (size_t k = 0; k < fds_per_event; ++k) {
+                    if (fds[e][k] < 0) continue;
+                    uint64_t raw[3] = {0, 0, 0};  // value, time_enabled, time_running
+                    if (::read(fds[e][k], raw, sizeof(raw)) != static_cast<ssize_t>(sizeof(raw))) continue;
+                    uint64_t value = raw[0];
+                    if (raw[2] > 0 && raw[2] < raw[1]) {
+                        value = static_cast<uint64_t>(static_cast<double>(value) * raw[1] / raw[2]);
+                    }
+                    sample.values[e] += value * (e == FP_OPS ? fp_weights[k] : 1);
+                }
+            }
+        }
+#endif
+        return sample;
+    }
+
+    /**
+     * @brief Computes the counts between two readings
+     */
+    static Sample delta(const Sample& begin, const Sample& end) {
+        Sample result;
+        for (size_t i = 0; i < EVENT_COUNT; ++i) {
+            result.values[i] = end.values[i] >= begin.values[i] ? end.values[i] - begin.values[i] : 0;
+        }
+        return result;
+    }
+
+    ~PerfCounters() {
+#ifdef __linux__
+        for (auto& thread : m_fds) {
+            for (auto& fds : thread) {
+                for (int fd : fds) {
+                    if (fd >= 0) ::close(fd);
+                }
+            }
+        }
+#endif
+    }
+
+private:
+    static constexpr size_t fds_per_event = 3;  ///< FP_OPS is the sum of up to three raw events
+    using ThreadFds = std::array<std::array<int, fds_per_event>, EVENT_COUNT>;
+
+    PerfCounters() {
+        m_available.fill(false);
+    }
+
+#ifdef __linux__
+    /**
+     * @brief Opens every event on the calling thread (-1 for the events that cannot be opened)
+     */
+    ThreadFds open_thread() {
+        ThreadFds fds;
+        for (auto& event : fds) event.fill(-1);
+        fds[CYCLES][0] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        fds[INSTRUCTIONS][0] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        fds[LLC_MISSES][0] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        fds[DTLB_MISSES][0] = open_event(PERF_TYPE_HW_CACHE,
+            PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+        if (is_intel()) {
+            // FP_ARITH_INST_RETIRED: scalar double, 128-bit packed double, 256-bit packed double
+            fds[FP_OPS][0] = open_event(PERF_TYPE_RAW, 0x01C7);
+            fds[FP_OPS][1] = open_event(PERF_TYPE_RAW, 0x04C7);
+            fds[FP_OPS][2] = open_event(PERF_TYPE_RAW, 0x10C7);
+        }
+        return fds;
+    }
+
+    int open_event(uint32_t type, uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        if (fd < 0) m_errno = errno;
+        return fd;
+    }
+
+    static bool is_intel() {
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line)) {
+            if (line.rfind("vendor_id", 0) == 0) return line.find("GenuineIntel") != std::string::npos;
+        }
+        return false;
+    }
+#endif
+
+    std::vector<ThreadFds> m_fds;                                   ///< Counter file descriptors per thread (-1 if closed)
+    std::array<bool, EVENT_COUNT> m_available;                      ///< Whether each event is counted
+    bool m_enabled = false;                                         ///< At least one counter is open
+    int m_errno = 0;                                                ///< Last perf_event_open error
+    std::string m_status = "disabled";                              ///< Human-readable state
+    std::mutex m_mutex;                                             ///< Guards enable()
+};
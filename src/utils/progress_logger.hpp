@@ -0,0 +1,194 @@
+/**
+ * @file progress_logger.hpp
+ * @brief Asynchronous progress log of the time loop
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ *
+ * The solver pushes fixed-size binary records into a lock-free queue
+ * (push: a few stores, no formatting, no allocation, never blocks); a
+ * background thread formats them as console columns, CSV or JSON lines.
+ * When the queue is full the record is dropped and counted, so a slow
+ * terminal cannot slow the time loop down.
+ */
+#pragma once
+#include "spsc_queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+/**
+ * @struct ProgressRecord
+ * @brief Progress of one iteration, or report of an output written at that iteration
+ */
+struct ProgressRecord {
+    enum class Kind : uint32_t { Step, Bricks };
+
+    Kind kind = Kind::Step;     ///< Step: progress line; Bricks: .hbrk snapshot written
+    uint64_t iteration = 0;     ///< Iteration
+    double time = 0.0;          ///< Simulated time (s)
+    double variation = 0.0;     ///< Variation of the step
+    uint64_t step_ns = 0;       ///< Computation time of the step
+    uint64_t elapsed_ms = 0;    ///< Computation time since the start
+    double mlups = 0.0;         ///< Million lattice updates per second since the start
+    double ratio = 0.0;         ///< Bricks: compression ratio
+    double max_error = 0.0;     ///< Bricks: largest absolute error of the stored values
+    double error_bound = 0.0;   ///< Bricks: absolute error bound (0: lossless)
+};
+
+/**
+ * @class ProgressLogger
+ * @brief Background thread formatting the progress records
+ */
+class ProgressLogger {
+public:
+    enum class Format { Console, Csv, Json };
+
+    /**
+     * @brief Writes the header of the format and starts the thread
+     * @param format "console", "csv" or "json"
+     * @param file Destination file (empty for the standard output)
+     * @param capacity Records the queue holds before dropping
+     * @throw std::runtime_error for an unknown format or a file that cannot be opened
+     */
+    ProgressLogger(const std::string& format, const std::string& file, size_t capacity = 4096)
+        : m_queue(capacity), m_out(nullptr), m_stop(false), m_dropped(0) {
+        if (format == "console") m_format = Format::Console;
+        else if (format == "csv") m_format = Format::Csv;
+        else if (format == "json") m_format = Format::Json;
+        else throw std::runtime_error("Unknown progress format " + format + " (console, csv or json)");
+
+        if (!file.empty()) {
+            m_out = std::fopen(file.c_str(), "w");
+            if (!m_out) {
+                throw std::runtime_error("Impossible to open the file " + file);
+            }
+        }
+        if (m_format == Format::Console) {
+            emit("%-8s%-15s%-15s%-15s%-10s\n", "Iter", "Sim Time", "Variation", "Comp Time (ms)", "MLUPS");
+        } else if (m_format == Format::Csv) {
+            emit("%s", "iteration,time,variation,step_ns,elapsed_ms,mlups\n");
+        }
+        m_thread = std::thread(&ProgressLogger::run, this);
+    }
+
+    ~ProgressLogger() { close(); }
+
+    ProgressLogger(const ProgressLogger&) = delete;
+    ProgressLogger& operator=(const ProgressLogger&) = delete;
+
+    /**
+     * @brief Queues a record (solver thread only)
+     */
+    void push(const ProgressRecord& record) {
+        ProgressRecord copy = record;
+        if (!m_queue.try_push(copy)) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Writes the pending records and stops the thread
+     */
+    void close() {
+        if (!m_thread.joinable()) return;
+        m_stop.store(true);
+        m_thread.join();
+        if (m_out) {
+            std::fclose(m_out);
+            m_out = nullptr;
+        } else {
+            std::cout.flush();
+        }
+    }
+
+    uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }  ///< Records lost to a full queue
+
+private:
+    /**
+     * @brief Thread body: drains the queue, sleeps briefly when it is empty
+     */
+    void run() {
+        ProgressRecord record;
+        for (;;) {
+            // Lu avant de vider la file : après l'arrêt, plus aucun push
+            const bool stopping = m_stop.load();
+            while (m_queue.try_pop(record)) {
+                write(record);
+            }
+            if (stopping) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    void write(const ProgressRecord& r) {
+        if (r.kind == ProgressRecord::Kind::Bricks) {
+            write_bricks(r);
+            return;
+        }
+        switch (m_format) {
+        case Format::Console:
+            emit("%-8llu%-15.3e%-20.3e%-15llu%-10.1f\n", static_cast<unsigned long long>(r.iteration), r.time,
+                 r.variation, static_cast<unsigned long long>(r.elapsed_ms), r.mlups);
+            break;
+        case Format::Csv:
+            emit("%llu,%.9e,%.9e,%llu,%llu,%.3f\n", static_cast<unsigned long long>(r.iteration), r.time,
+                 r.variation, static_cast<unsigned long long>(r.step_ns),
+                 static_cast<unsigned long long>(r.elapsed_ms), r.mlups);
+            break;
+        case Format::Json:
+            emit("{\"iteration\":%llu,\"time\":%.9e,\"variation\":%.9e,\"step_ns\":%llu,\"elapsed_ms\":%llu,\"mlups\":%.3f}\n",
+                 static_cast<unsigned long long>(r.iteration), r.time, r.variation,
+                 static_cast<unsigned long long>(r.step_ns), static_cast<unsigned long long>(r.elapsed_ms), r.mlups);
+            break;
+        }
+    }
+
+    /**
+     * @brief Report of a brick snapshot (a comment line in CSV, so the columns stay intact)
+     */
+    void write_bricks(const ProgressRecord& r) {
+        const unsigned long long iteration = static_cast<unsigned long long>(r.iteration);
+        switch (m_format) {
+        case Format::Console:
+            emit("Bricks %llu: ratio %.2f, max error %.3e (bound %.3e)\n", iteration, r.ratio, r.max_error, r.error_bound);
+            break;
+        case Format::Csv:
+            emit("# bricks,%llu,%.3f,%.9e,%.9e\n", iteration, r.ratio, r.max_error, r.error_bound);
+            break;
+        case Format::Json:
+            emit("{\"bricks\":%llu,\"ratio\":%.3f,\"max_error\":%.9e,\"error_bound\":%.9e}\n",
+                 iteration, r.ratio, r.max_error, r.error_bound);
+            break;
+        }
+    }
+
+    /**
+     * @brief Formats a line in a stack buffer and writes it in one call
+     */
+    template <typename... Args>
+    void emit(const char* format, Args... args) {
+        char line[256];
+        const int n = std::snprintf(line, sizeof(line), format, args...);
+        if (n <= 0) return;
+        const size_t length = std::min(static_cast<size_t>(n), sizeof(line) - 1);
+        if (m_out) {
+            std::fwrite(line, 1, length, m_out);
+        } else {
+            std::cout.write(line, static_cast<std::streamsize>(length));
+        }
+    }
+
+    SpscQueue<ProgressRecord> m_queue;          ///< Solver -> logger
+    Format m_format;                            ///< Output format
+    std::FILE* m_out;                           ///< Destination file (nullptr: standard output)
+    std::atomic<bool> m_stop;                   ///< Asks the thread to drain and exit
+    std::atomic<uint64_t> m_dropped;            ///< Records dropped on a full queue
+    std::thread m_thread;                       ///< Logger thread
+};
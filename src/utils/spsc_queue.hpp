@@ -0,0 +1,75 @@
+/**
+ * @file spsc_queue.hpp
+ * @brief Bounded lock-free single-producer single-consumer queue
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ *
+ * This utility passes items between exactly two threads without locks:
+ * the producer only writes the tail index and the consumer only writes
+ * the head index, each on its own cache line.
+ */
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/**
+ * @class SpscQueue
+ * @brief Ring buffer of fixed capacity (rounded up to a power of two)
+ */
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity + 1) size *= 2;
+        m_slots.resize(size);
+        m_mask = size - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    /**
+     * @brief Appends an item (producer thread only)
+     * @return false if the queue is full, in which case item is left untouched
+     */
+    bool try_push(T& item) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t next = (tail + 1) & m_mask;
+        if (next == m_head.load(std::memory_order_acquire)) return false;
+        m_slots[tail] = std::move(item);
+        m_tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(T&& item) { return try_push(item); }
+
+    /**
+     * @brief Removes the oldest item (consumer thread only)
+     * @return false if the queue is empty
+     */
+    bool try_pop(T& item) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) return false;
+        item = std::move(m_slots[head]);
+        m_head.store((head + 1) & m_mask, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Approximate emptiness test, exact when called by the consumer
+     */
+    bool empty() const {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const { return m_mask; }
+
+private:
+    std::vector<T> m_slots;                         ///< Ring storage (one slot always free)
+    size_t m_mask = 0;                              ///< Size of m_slots minus one
+    alignas(64) std::atomic<size_t> m_head{0};      ///< Next slot to pop (written by the consumer)
+    alignas(64) std::atomic<size_t> m_tail{0};      ///< Next slot to push (written by the producer)
+};
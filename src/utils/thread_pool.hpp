@@ -0,0 +1,278 @@
+/**
+ * @file thread_pool.hpp
+ * @brief Persistent fork-join thread pool
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ *
+ * This utility keeps a fixed set of worker threads alive for the whole
+ * run, so that parallel sections executed every time step do not pay the
+ * cost of creating threads. The calling thread takes part in each parallel
+ * section as worker 0.
+ *
+ * Each parallel_for records, per named phase and per worker, the time
+ * spent on the worker's own block (compute), on chunks taken from other
+ * workers (steal) and idle until the slowest worker finished (wait), so
+ * that load imbalance can be reported at the end of the run.
+ */
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Runs a task on every worker and waits for all of them
+ *
+ * Work partitioning is left to the task, which receives its worker index
+ * in [0, size()). Parallel sections must not be nested.
+ */
+class ThreadPool {
+public:
+    /**
+     * @struct WorkerTimes
+     * @brief Time breakdown of one worker, accumulated over the sections of a phase
+     */
+    struct alignas(64) WorkerTimes {
+        long long compute_ns = 0;   ///< Time on chunks of the worker's own block
+        long long steal_ns = 0;     ///< Time on chunks taken from other workers
+        long long wait_ns = 0;      ///< Time idle until the end of the section
+        uint64_t chunks = 0;        ///< Chunks of the own block
+        uint64_t stolen = 0;        ///< Chunks taken from other workers
+
+        long long busy_ns() const { return compute_ns + steal_ns; }
+    };
+
+    /**
+     * @struct PhaseProfile
+     * @brief Per-worker breakdown of every section run under one phase name
+     */
+    struct PhaseProfile {
+        uint64_t sections = 0;              ///< Number of parallel_for calls
+        long long wall_ns = 0;              ///< Elapsed time of the sections
+        std::vector<WorkerTimes> workers;   ///< One entry per worker
+
+        /**
+         * @brief Load imbalance factor: slowest worker's busy time over the mean (1 = perfect)
+         */
+        double imbalance() const {
+            long long max_busy = 0, total_busy = 0;
+            for (const auto& worker : workers) {
+                max_busy = std::max(max_busy, worker.busy_ns());
+                total_busy += worker.busy_ns();
+            }
+            return total_busy > 0 ? static_cast<double>(max_busy) * workers.size() / total_busy : 1.0;
+        }
+    };
+
+    /**
+     * @brief Constructor
+     * @param threads Total number of workers, including the calling thread (0 = hardware concurrency)
+     */
+    explicit ThreadPool(size_t threads = 0) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        for (size_t worker = 1; worker < threads; ++worker) {
+            m_threads.emplace_back([this, worker]() { worker_loop(worker); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_start.notify_all();
+        for (auto& thread : m_threads) thread.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Number of workers, including the calling thread
+     */
+    size_t size() const { return m_threads.size() + 1; }
+
+    /**
+     * @brief Executes task(worker) on every worker and waits for completion
+     * @param task Function receiving the worker index
+     * @throw The first exception thrown by a worker, once all of them are done
+     */
+    void run(const std::function<void(size_t)>& task) {
+        if (m_threads.empty()) {
+            task(0);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_task = &task;
+            m_pending = m_threads.size();
+            m_error = nullptr;
+            ++m_generation;
+        }
+        m_start.notify_all();
+
+        try {
+            task(0);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_error) m_error = std::current_exception();
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this]() { return m_pending == 0; });
+        m_task = nullptr;
+        if (m_error) std::rethrow_exception(m_error);
+    }
+
+    /**
+     * @brief Splits [begin, end) in contiguous blocks, one per worker
+     * @param begin First index of the range
+     * @param end One past the last index
+     * @param body Function receiving (block_begin, block_end, worker)
+     * @param phase Name under which the worker times are accumulated
+     * @param grain 0 to give each worker a single block; otherwise blocks are
+     *        processed in chunks of grain indices and idle workers steal chunks
+     *        from the others, so body may be called several times per worker
+     */
+    void parallel_for(size_t begin, size_t end, const std::function<void(size_t, size_t, size_t)>& body,
+                      const std::string& phase = "parallel_for", size_t grain = 0) {
+        using clock = std::chrono::steady_clock;
+        const size_t workers = size();
+        const size_t count = end > begin ? end - begin : 0;
+
+        // Curseur par bloc, sur sa propre ligne de cache
+        struct alignas(64) Block {
+            std::atomic<size_t> next{0};
+            size_t end = 0;
+        };
+        std::unique_ptr<Block[]> blocks(new Block[workers]);
+        for (size_t worker = 0; worker < workers; ++worker) {
+            blocks[worker].next.store(begin + count * worker / workers, std::memory_order_relaxed);
+            blocks[worker].end = begin + count * (worker + 1) / workers;
+        }
+        std::vector<WorkerTimes> times(workers);
+
+        const auto start = clock::now();
+        run([&](size_t worker) {
+            WorkerTimes& time = times[worker];
+            for (size_t offset = 0; offset < workers; ++offset) {
+                if (grain == 0 && offset > 0) break;
+                Block& block = blocks[(worker + offset) % workers];
+                const size_t step = grain == 0 ? count + 1 : grain;
+                for (;;) {
+                    const size_t first = block.next.fetch_add(step, std::memory_order_relaxed);
+                    if (first >= block.end) break;
+                    const size_t last = std::min(first + step, block.end);
+
+                    const auto chunk_start = clock::now();
+                    body(first, last, worker);
+                    const long long elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - chunk_start).count();
+                    if (offset == 0) {
+                        time.compute_ns += elapsed;
+                        ++time.chunks;
+                    } else {
+                        time.steal_ns += elapsed;
+                        ++time.stolen;
+                    }
+                }
+            }
+        });
+        const long long wall = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+
+        PhaseProfile& profile = m_profile[phase];
+        profile.workers.resize(workers);
+        ++profile.sections;
+        profile.wall_ns += wall;
+        for (size_t worker = 0; worker < workers; ++worker) {
+            WorkerTimes& total = profile.workers[worker];
+            total.compute_ns += times[worker].compute_ns;
+            total.steal_ns += times[worker].steal_ns;
+            total.wait_ns += std::max(0LL, wall - times[worker].busy_ns());
+            total.chunks += times[worker].chunks;
+            total.stolen += times[worker].stolen;
+        }
+    }
+
+    /**
+     * @brief Worker times accumulated per phase since construction
+     */
+    const std::map<std::string, PhaseProfile>& profile() const { return m_profile; }
+
+    /**
+     * @brief Displays the compute/steal/wait breakdown and the imbalance factor of each phase
+     */
+    void display_profile() const {
+        const size_t inner_width = 79;
+        auto ms = [](long long ns) { return static_cast<double>(ns) * 1e-6; };
+
+        std::cout << "+" << std::string(inner_width, '-') << "+\n";
+        for (const auto& phase : m_profile) {
+            std::ostringstream title;
+            title << " " << phase.first << ": " << phase.second.sections << " sections, imbalance (max/mean) "
+                  << std::fixed << std::setprecision(3) << phase.second.imbalance();
+            std::cout << "|" << std::left << std::setw(inner_width) << title.str() << "|\n"
+                      << "+" << std::string(inner_width, '-') << "+\n"
+                      << "| " << std::left << std::setw(9) << "Worker" << std::right
+                      << std::setw(14) << "compute ms" << std::setw(14) << "steal ms" << std::setw(14) << "wait ms"
+                      << std::setw(13) << "chunks" << std::setw(13) << "stolen" << " |\n";
+            for (size_t worker = 0; worker < phase.second.workers.size(); ++worker) {
+                const WorkerTimes& time = phase.second.workers[worker];
+                std::cout << "| " << std::left << std::setw(9) << worker << std::right << std::fixed << std::setprecision(3)
+                          << std::setw(14) << ms(time.compute_ns) << std::setw(14) << ms(time.steal_ns)
+                          << std::setw(14) << ms(time.wait_ns)
+                          << std::setw(13) << time.chunks << std::setw(13) << time.stolen << " |\n";
+            }
+            std::cout << "+" << std::string(inner_width, '-') << "+\n";
+        }
+    }
+
+private:
+    void worker_loop(size_t worker) {
+        size_t seen = 0;
+        for (;;) {
+            const std::function<void(size_t)>* task = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_start.wait(lock, [&]() { return m_stopping || m_generation != seen; });
+                if (m_stopping) return;
+                seen = m_generation;
+                task = m_task;
+            }
+
+            try {
+                (*task)(worker);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_error) m_error = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_pending == 0) m_done.notify_one();
+        }
+    }
+
+    std::vector<std::thread> m_threads;                     ///< Workers 1..size()-1
+    std::mutex m_mutex;                                     ///< Guards the fields below
+    std::condition_variable m_start;                        ///< Signals a new parallel section
+    std::condition_variable m_done;                         ///< Signals the end of a section
+    const std::function<void(size_t)>* m_task = nullptr;    ///< Task of the current section
+    size_t m_generation = 0;                                ///< Number of sections started
+    size_t m_pending = 0;                                   ///< Workers still running the section
+    bool m_stopping = false;                                ///< Set by the destructor
+    std::exception_ptr m_error;                             ///< First exception of the section
+    std::map<std::string, PhaseProfile> m_profile;          ///< Worker times per phase (caller thread only)
+};
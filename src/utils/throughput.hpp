@@ -0,0 +1,137 @@
+/**
+ * @file throughput.hpp
+ * @brief Throughput metrics (MLUPS, GB/s, GFLOP/s) and memory roofline
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ *
+ * This utility converts a number of lattice updates and a duration into
+ * the figures used to tune a stencil code, from the known per-update byte
+ * and flop counts of the kernel. It also measures a STREAM-like triad
+ * bandwidth that serves as the ceiling of a memory-bound roofline.
+ */
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @struct StencilCost
+ * @brief Compulsory memory traffic and arithmetic of one lattice update
+ */
+struct StencilCost {
+    double bytes_per_update;   ///< Bytes moved to/from main memory per updated point
+    double flops_per_update;   ///< Floating-point operations per updated point (force excluded)
+
+    /**
+     * @brief Arithmetic intensity of the kernel
+     * @return Flops per byte
+     */
+    double intensity() const { return bytes_per_update > 0 ? flops_per_update / bytes_per_update : 0.0; }
+};
+
+/**
+ * @struct Throughput
+ * @brief Rates achieved over a phase
+ */
+struct Throughput {
+    double mlups;    ///< Million lattice updates per second
+    double gbps;     ///< Effective memory bandwidth in GB/s
+    double gflops;   ///< Floating-point rate in GFLOP/s
+
+    /**
+     * @brief Computes the rates of a phase
+     * @param updates Number of lattice updates performed
+     * @param seconds Duration of the phase
+     * @param cost Per-update cost of the kernel
+     */
+    static Throughput compute(uint64_t updates, double seconds, const StencilCost& cost) {
+        if (seconds <= 0.0) return Throughput{0.0, 0.0, 0.0};
+        const double rate = static_cast<double>(updates) / seconds;
+        return Throughput{rate * 1e-6, rate * cost.bytes_per_update * 1e-9, rate * cost.flops_per_update * 1e-9};
+    }
+};
+
+/**
+ * @brief Measures the sustainable memory bandwidth with a STREAM triad
+ * @param elements Length of each of the three arrays (default: 3 x 64 MB)
+ * @param repetitions Number of timed repetitions, the best one is kept
+ * @return Bandwidth in GB/s, counting 24 bytes per element as STREAM does
+ */
+inline double measure_stream_bandwidth(size_t elements = size_t(1) << 23, int repetitions = 5) {
+    std::vector<double> a(elements, 0.0), b(elements, 1.0), c(elements, 2.0);
+    const double scalar = 3.0;
+    double best = 0.0;
+
+    for (int r = 0; r < repetitions; ++r) {
+        const auto start = std::chrono::steady_clock::now();
+        double* __restrict pa = a.data();
+        const double* __restrict pb = b.data();
+        const double* __restrict pc = c.data();
+        for (size_t i = 0; i < elements; ++i) {
+            pa[i] = pb[i] + scalar * pc[i];
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (seconds > 0.0) {
+            best = std::max(best, 3.0 * sizeof(double) * elements / seconds * 1e-9);
+        }
+    }
+
+    // Keep the result observable so the triad is not optimized away
+    volatile double sink = a[elements / 2];
+    (void)sink;
+    return best;
+}
+
+/**
+ * @brief Displays the achieved rates of each phase against the bandwidth ceiling
+ * @param phases Name and throughput of each phase
+ * @param cost Per-update cost of the kernel
+ * @param ceiling_gbps Measured memory bandwidth ceiling (GB/s)
+ *
+ * In a memory-bound roofline the attainable flop rate is the arithmetic
+ * intensity times the bandwidth ceiling; each phase is reported as a
+ * fraction of it.
+ */
+inline void display_roofline(const std::vector<std::pair<std::string, Throughput>>& phases,
+                             const StencilCost& cost, double ceiling_gbps) {
+    const size_t inner_width = 79;
+    auto center_text = [](const std::string& text, size_t column_width) {
+        size_t padding = column_width - text.length();
+        size_t left_pad = padding / 2;
+        size_t right_pad = padding - left_pad;
+        return std::string(left_pad, ' ') + text + std::string(right_pad, ' ');
+    };
+    const double attainable = cost.intensity() * ceiling_gbps;
+
+    std::cout << "+" << std::string(inner_width, '-') << "+\n"
+              << "|" << center_text("Throughput", inner_width) << "|\n"
+              << "+" << std::string(inner_width, '-') << "+\n"
+              << std::fixed << std::setprecision(2)
+              << "| " << std::left << std::setw(inner_width - 1)
+              << ("Stencil: " + std::to_string(static_cast<int>(cost.bytes_per_update)) + " B/update, "
+                  + std::to_string(static_cast<int>(cost.flops_per_update)) + " flop/update") << "|\n";
+
+    std::ostringstream ceiling;
+    ceiling << std::fixed << std::setprecision(2) << "Ceiling: " << ceiling_gbps << " GB/s (triad), "
+            << attainable << " GFLOP/s attainable";
+    std::cout << "| " << std::left << std::setw(inner_width - 1) << ceiling.str() << "|\n"
+              << "+" << std::string(inner_width, '-') << "+\n"
+              << "| " << std::left << std::setw(15) << "Phase" << std::right
+              << std::setw(14) << "MLUPS" << std::setw(14) << "GB/s" << std::setw(14) << "GFLOP/s"
+              << std::setw(20) << "% of ceiling" << " |\n";
+
+    for (const auto& phase : phases) {
+        const double fraction = ceiling_gbps > 0.0 ? 100.0 * phase.second.gbps / ceiling_gbps : 0.0;
+        std::cout << "| " << std::left << std::setw(15) << phase.first << std::right
+                  << std::setw(14) << phase.second.mlups
+                  << std::setw(14) << phase.second.gbps
+                  << std::setw(14) << phase.second.gflops
+                  << std::setw(20) << fraction << " |\n";
+    }
+    std::cout << "+" << std::string(inner_width, '-') << "+\n";
+}
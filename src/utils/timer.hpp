@@ -10,10 +10,18 @@
  */
 #pragma once
 #include <iostream>
+#include <iomanip>
 #include <string>
 #include <unordered_map>
+#include <map>
+#include <sstream>
+#include <algorithm>
 #include <chrono>
 #include <thread>
+#include "histogram.hpp"
+#include "trace.hpp"
+#include "perf_counters.hpp"
+#include "memory_tracker.hpp"
  
 /**
  * @class Timer
@@ -21,7 +29,10 @@
  * 
  * The Timer class provides functionality to measure elapsed time between
  * start and stop points. It can accumulate multiple timing intervals and
- * provides the total elapsed time.
+ * provides the total elapsed time. Every interval is also recorded in a
+ * latency histogram so that outliers remain visible behind the total,
+ * emitted as a trace event when the TraceRecorder is enabled, and charged
+ * with the hardware counter deltas when PerfCounters are enabled.
  */
 class Timer {
 public:
@@ -29,14 +40,14 @@ public:
      * @brief Default constructor
      * Creates a timer with the name "Unnamed Timer"
      */
-    Timer() : m_name("Unnamed Timer"), m_startTime(), m_endTime(), m_running(false), m_elapsed(0) {}
+    Timer() : m_name("Unnamed Timer"), m_startTime(), m_endTime(), m_running(false), m_elapsed(0), m_histogram(), m_traceId(-1), m_traceBegin(0), m_counterStart(), m_counters() {}
 
     /**
      * @brief Constructor with custom name
      * @param name The name identifier for the timer
      */
     explicit Timer(const std::string& name) 
-        : m_name(name), m_startTime(), m_endTime(), m_running(false), m_elapsed(0) {}
+        : m_name(name), m_startTime(), m_endTime(), m_running(false), m_elapsed(0), m_histogram(), m_traceId(-1), m_traceBegin(0), m_counterStart(), m_counters() {}
 
     /**
      * @brief Starts the timer
@@ -46,6 +57,12 @@ public:
      */
     void start() {
         if (!m_running) {
+            if (TraceRecorder::instance().enabled()) {
+                m_traceBegin = TraceRecorder::instance().now_ns();
+            }
+            if (PerfCounters::instance().enabled()) {
+                m_counterStart = PerfCounters::instance().read();
+            }
             m_startTime = std::chrono::high_resolution_clock::now();
             m_running = true;
         }
@@ -54,15 +71,28 @@ public:
     /**
      * @brief Stops the timer
      * 
-     * Records the current time as the end time and adds the interval to
-     * the total elapsed time. If the timer is not running, this operation
-     * has no effect.
+     * Records the current time as the end time, adds the interval to
+     * the total elapsed time and records it in the latency histogram.
+     * If the timer is not running, this operation has no effect.
      */
     void stop() {
         if (m_running) {
             m_endTime = std::chrono::high_resolution_clock::now();
-            m_elapsed += std::chrono::duration_cast<std::chrono::milliseconds>(m_endTime - m_startTime).count();
+            const auto interval = std::chrono::duration_cast<std::chrono::nanoseconds>(m_endTime - m_startTime).count();
+            m_elapsed += interval;
+            m_histogram.record(static_cast<uint64_t>(interval));
             m_running = false;
+
+            if (PerfCounters::instance().enabled()) {
+                m_counters += PerfCounters::delta(m_counterStart, PerfCounters::instance().read());
+            }
+
+            TraceRecorder& recorder = TraceRecorder::instance();
+            if (recorder.enabled() && m_traceBegin != 0) {
+                if (m_traceId < 0) m_traceId = static_cast<int>(recorder.intern(m_name));
+                recorder.record(static_cast<uint32_t>(m_traceId), m_traceBegin, recorder.now_ns());
+                m_traceBegin = 0;
+            }
         }
     }
 
@@ -76,16 +106,45 @@ public:
     long get_elapsed() const {
         if (m_running) {
             auto now = std::chrono::high_resolution_clock::now();
-            return m_elapsed + std::chrono::duration_cast<std::chrono::milliseconds>(now - m_startTime).count();
+            return (m_elapsed + std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_startTime).count()) / 1000000;
         }
-        return m_elapsed;
+        return m_elapsed / 1000000;
     }
 
+    /**
+     * @brief Gets the total elapsed time with full resolution
+     * @return The total elapsed time in seconds
+     */
+    double get_elapsed_seconds() const {
+        long long elapsed = m_elapsed;
+        if (m_running) {
+            auto now = std::chrono::high_resolution_clock::now();
+            elapsed += std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_startTime).count();
+        }
+        return static_cast<double>(elapsed) * 1e-9;
+    }
+
+    /**
+     * @brief Gets the distribution of the measured intervals
+     * @return Histogram of every start/stop interval, in nanoseconds
+     */
+    const LatencyHistogram& histogram() const { return m_histogram; }
+
+    /**
+     * @brief Gets the hardware counts accumulated over all intervals
+     * @return Counter totals (all zero if PerfCounters are not enabled)
+     */
+    const PerfCounters::Sample& counters() const { return m_counters; }
+
+    const std::string& name() const { return m_name; }
+
     /**
      * @brief Displays the timer's name and elapsed time
      * 
      * Outputs the timer information to standard output in the format:
-     * "[name]: [elapsed] ms"
+     * "[name]: [elapsed] ms | [count] [p50] [p90] [p99] [max]"
+     * Percentiles are given in milliseconds and only shown when the timer
+     * measured more than one interval.
      */
     // void display() const {
     // //  std::cout << m_name << ": " << get_elapsed() << " ms" << std::endl;
@@ -103,7 +162,20 @@ public:
         };
         // std::cout << "| " << center_text(m_name, inner_width) << get_elapsed() << " ms |\n";
 
-        std::cout << "| " << std::left << std::setw(15) << m_name << ": " << std::setw(7) << get_elapsed() << " ms |\n";
+        std::cout << "| " << std::left << std::setw(15) << m_name << ": " << std::setw(7) << get_elapsed() << " ms |";
+
+        std::cout << std::right << std::setw(8) << m_histogram.count();
+        if (m_histogram.count() > 1) {
+            auto to_ms = [](uint64_t ns) { return static_cast<double>(ns) * 1e-6; };
+            std::cout << std::fixed << std::setprecision(3)
+                      << std::setw(10) << to_ms(m_histogram.percentile(50))
+                      << std::setw(10) << to_ms(m_histogram.percentile(90))
+                      << std::setw(10) << to_ms(m_histogram.percentile(99))
+                      << std::setw(10) << to_ms(m_histogram.max());
+        } else {
+            std::cout << std::setw(10) << "-" << std::setw(10) << "-" << std::setw(10) << "-" << std::setw(10) << "-";
+        }
+        std::cout << " |";
 
         // std::cout << "+" << std::string(inner_width, '-') << "+\n"
         //           << "| " << std::left << std::setw(15) << m_name
@@ -116,7 +188,12 @@ private:
     std::chrono::time_point<std::chrono::high_resolution_clock> m_startTime;   ///< Last start time point
     std::chrono::time_point<std::chrono::high_resolution_clock> m_endTime;     ///< Last end time point
     bool m_running;                                                            ///< Timer running state
-    long m_elapsed;                                                            ///< Accumulated elapsed time in milliseconds
+    long long m_elapsed;                                                       ///< Accumulated elapsed time in nanoseconds
+    LatencyHistogram m_histogram;                                              ///< Distribution of the measured intervals
+    int m_traceId;                                                             ///< Interned trace name (-1 until first traced interval)
+    uint64_t m_traceBegin;                                                     ///< Start of the current interval on the trace clock (0 if not traced)
+    PerfCounters::Sample m_counterStart;                                       ///< Counter reading at the last start
+    PerfCounters::Sample m_counters;                                           ///< Accumulated counter deltas
 };
 
 /**
@@ -159,15 +236,74 @@ public:
         return m_timers.at(name);
     }
 
+    /**
+     * @brief Accesses a timer by name (read-only)
+     * @param name The name of the timer to access
+     * @return Const reference to the requested Timer object
+     * @throw std::out_of_range if the timer does not exist
+     */
+    const Timer& operator()(const std::string& name) const {
+        return m_timers.at(name);
+    }
+
+    /**
+     * @brief Starts recording timer intervals and trace scopes as trace events
+     * @param capacity_per_thread Maximum number of events kept per thread (oldest are dropped)
+     */
+    void enable_trace(size_t capacity_per_thread) {
+        TraceRecorder::instance().enable(capacity_per_thread);
+    }
+
+    /**
+     * @brief Writes the recorded trace events as a Chrome trace JSON file
+     * @param filename Path of the output file, loadable in Perfetto
+     * @throw std::runtime_error if the file cannot be opened
+     */
+    void write_trace(const std::string& filename) const {
+        TraceRecorder::instance().write(filename);
+    }
+
+    /**
+     * @brief Attaches hardware performance counters to every timer
+     * @return true if at least one counter is available
+     *
+     * Must be called from the thread that runs the timed scopes. When no
+     * counter can be opened the summary reports why and timing is unaffected.
+     */
+    bool enable_counters() {
+        m_countersRequested = true;
+        return PerfCounters::instance().enable();
+    }
+
+    /**
+     * @brief Sets the number of lattice updates performed by the run
+     * @param updates Interior points times iterations, used to normalize counters
+     */
+    void set_lattice_updates(uint64_t updates) { m_latticeUpdates = updates; }
+
+    /**
+     * @brief Reports work done by a background thread and how much of it the solver waited for
+     * @param name Name of the background stage
+     * @param busy_seconds Time the background thread spent working
+     * @param stalled_seconds Time the timed thread spent waiting on it
+     *
+     * The summary shows the fraction of the background work that was
+     * overlapped with computation: 1 - stalled / busy.
+     */
+    void set_background(const std::string& name, double busy_seconds, double stalled_seconds) {
+        m_background[name] = std::make_pair(busy_seconds, stalled_seconds);
+    }
+
     /**
      * @brief Displays timing information for all timers
      * 
      * Outputs the total time (sum of all timers except "Total")
-     * followed by the individual times for each timer.
+     * followed by the individual times for each timer, together with the
+     * number of measured intervals and their p50/p90/p99/max latencies.
      * Format:
      * Total: [total_time] ms
-     * [timer1_name]: [timer1_time] ms
-     * [timer2_name]: [timer2_time] ms
+     * [timer1_name]: [timer1_time] ms | [count] [p50] [p90] [p99] [max]
+     * [timer2_name]: [timer2_time] ms | [count] [p50] [p90] [p99] [max]
      * ...
      */
     // void display() const {
@@ -193,7 +329,7 @@ public:
     //     }
     // }
     void display() const {
-        const size_t width = 31;
+        const size_t width = 81;
         const size_t inner_width = width - 2;
     
         auto center_text = [](const std::string& text, size_t column_width) {
@@ -214,11 +350,15 @@ public:
         std::cout << "+" << std::string(inner_width, '-') << "+\n"
                   << "|" << center_text("Timer Summary", inner_width) << "|\n"
                   << "+" << std::string(inner_width, '-') << "+\n";
+        std::cout << "| " << std::left << std::setw(28) << "Timer" << "|"
+                  << std::right << std::setw(8) << "count"
+                  << std::setw(10) << "p50 ms" << std::setw(10) << "p90 ms"
+                  << std::setw(10) << "p99 ms" << std::setw(10) << "max ms" << " |\n"
+                  << "+" << std::string(inner_width, '-') << "+\n";
         
         // Total
-        std::cout << "| " << std::left << std::setw(15) << "Total"
-                  << std::right << std::setw(13) << total_time << " ms |\n";
-        // << "+" << std::string(inner_width, '-') << "+\n";
+        std::cout << "| " << std::left << std::setw(15) << "Total" << ": "
+                  << std::setw(7) << total_time << " ms |" << std::string(48, ' ') << " |\n";
 
         // Timers individuels
         for (const auto& pair : m_timers) {
@@ -228,9 +368,88 @@ public:
             }
         }
         std::cout << "+" << std::string(inner_width, '-') << "+\n";
+
+        // Étapes en arrière-plan (recouvrement avec le calcul)
+        for (const auto& stage : m_background) {
+            const double busy = stage.second.first;
+            const double stalled = stage.second.second;
+            const double overlap = busy > 0.0 ? 100.0 * std::max(0.0, 1.0 - stalled / busy) : 100.0;
+            std::ostringstream line;
+            line << " " << stage.first << ": " << std::fixed << std::setprecision(3) << busy
+                 << " s in background, " << stalled << " s stalled, "
+                 << std::setprecision(1) << overlap << "% overlapped";
+            std::cout << "|" << std::left << std::setw(inner_width) << line.str() << "|\n";
+        }
+        if (!m_background.empty()) {
+            std::cout << "+" << std::string(inner_width, '-') << "+\n";
+        }
+
+        if (m_countersRequested) {
+            display_counters();
+        }
+        if (!MemoryTracker::instance().owners().empty()) {
+            MemoryTracker::instance().display();
+        }
     }
 
 private:
+    /**
+     * @brief Displays the hardware counters of each timer
+     *
+     * Reports instructions per cycle, and cycles, LLC misses, dTLB misses
+     * and FP operations per lattice update (see set_lattice_updates).
+     */
+    void display_counters() const {
+        const size_t inner_width = 79;
+        const PerfCounters& counters = PerfCounters::instance();
+
+        const std::string title = counters.threads() > 1
+            ? " Hardware counters (per lattice update, " + std::to_string(counters.threads()) + " threads)"
+            : " Hardware counters (per lattice update)";
+        std::cout << "|" << std::left << std::setw(inner_width) << title << "|\n"
+                  << "+" << std::string(inner_width, '-') << "+\n";
+        if (!counters.enabled()) {
+            std::cout << "| " << std::left << std::setw(inner_width - 1) << ("unavailable: " + counters.status()).substr(0, inner_width - 1) << "|\n"
+                      << "+" << std::string(inner_width, '-') << "+\n";
+            return;
+        }
+
+        std::cout << "| " << std::left << std::setw(15) << "Timer" << std::right
+                  << std::setw(10) << "IPC" << std::setw(14) << "cycles" << std::setw(14) << "LLC miss"
+                  << std::setw(14) << "dTLB miss" << std::setw(10) << "FP ops" << " |\n";
+
+        auto column = [&](PerfCounters::Event event, double value, int width) {
+            if (!counters.available(event) || (event != PerfCounters::INSTRUCTIONS && m_latticeUpdates == 0)) {
+                std::cout << std::setw(width) << "n/a";
+            } else {
+                std::cout << std::setw(width) << std::fixed << std::setprecision(3) << value;
+            }
+        };
+
+        for (const auto& pair : m_timers) {
+            if (pair.first == "Total" || pair.second.histogram().count() == 0) continue;
+            const auto& values = pair.second.counters().values;
+            const double updates = static_cast<double>(m_latticeUpdates);
+            const double cycles = static_cast<double>(values[PerfCounters::CYCLES]);
+
+            std::cout << "| " << std::left << std::setw(15) << pair.first << std::right;
+            if (counters.available(PerfCounters::CYCLES) && cycles > 0) {
+                column(PerfCounters::INSTRUCTIONS, values[PerfCounters::INSTRUCTIONS] / cycles, 10);
+            } else {
+                std::cout << std::setw(10) << "n/a";
+            }
+            column(PerfCounters::CYCLES, cycles / updates, 14);
+            column(PerfCounters::LLC_MISSES, values[PerfCounters::LLC_MISSES] / updates, 14);
+            column(PerfCounters::DTLB_MISSES, values[PerfCounters::DTLB_MISSES] / updates, 14);
+            column(PerfCounters::FP_OPS, values[PerfCounters::FP_OPS] / updates, 10);
+            std::cout << " |\n";
+        }
+        std::cout << "+" << std::string(inner_width, '-') << "+\n";
+    }
+
     std::unordered_map<std::string, Timer> m_timers;  ///< Container for all timer objects
+    bool m_countersRequested = false;                 ///< Whether enable_counters() was called
+    uint64_t m_latticeUpdates = 0;                    ///< Work done by the run, to normalize counters
+    std::map<std::string, std::pair<double, double>> m_background;  ///< Busy and stalled seconds per stage
 };
 
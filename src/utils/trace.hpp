@@ -0,0 +1,231 @@
+/**
+ * @file trace.hpp
+ * @brief Chrome trace-event recorder for solver phases
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ *
+ * This utility records begin/end pairs of named scopes, per thread, into
+ * bounded ring buffers and writes them as a Chrome trace JSON file that
+ * can be opened in Perfetto (ui.perfetto.dev) or chrome://tracing.
+ * Recording is disabled by default; when disabled a scope costs one
+ * relaxed atomic load.
+ */
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class TraceRecorder
+ * @brief Process-wide collector of trace events
+ *
+ * Each thread owns a fixed-capacity ring buffer, created on its first
+ * event. When a ring is full the oldest events are overwritten and
+ * counted as dropped, so memory stays bounded on arbitrarily long runs.
+ * Events are stored as complete events (begin + duration), which keeps
+ * the file consistent even when the ring wrapped in the middle of a scope.
+ */
+class TraceRecorder {
+public:
+    /**
+     * @brief Gets the process-wide recorder
+     */
+    static TraceRecorder& instance() {
+        static TraceRecorder recorder;
+        return recorder;
+    }
+
+    /**
+     * @brief Starts recording
+     * @param capacity_per_thread Maximum number of events kept per thread
+     */
+    void enable(size_t capacity_per_thread = 1 << 16) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_capacity = capacity_per_thread > 0 ? capacity_per_thread : 1;
+        m_enabled.store(true, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Stops recording (already recorded events are kept)
+     */
+    void disable() { m_enabled.store(false, std::memory_order_relaxed); }
+
+    bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Gets a stable identifier for a scope name
+     * @param name The name displayed in the trace viewer
+     * @return Identifier to pass to record()
+     */
+    uint32_t intern(const std::string& name) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_ids.find(name);
+        if (it != m_ids.end()) return it->second;
+        const uint32_t id = static_cast<uint32_t>(m_names.size());
+        m_names.push_back(name);
+        m_ids[name] = id;
+        return id;
+    }
+
+    /**
+     * @brief Current time on the trace clock
+     * @return Nanoseconds since the recorder was created
+     */
+    uint64_t now_ns() const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - m_epoch).count());
+    }
+
+    /**
+     * @brief Records a finished scope on the calling thread
+     * @param name Identifier returned by intern()
+     * @param begin_ns Scope start, from now_ns()
+     * @param end_ns Scope end, from now_ns()
+     */
+    void record(uint32_t name, uint64_t begin_ns, uint64_t end_ns) {
+        if (!enabled()) return;
+        ThreadBuffer& buffer = thread_buffer();
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+        Event& event = buffer.ring[buffer.written % buffer.ring.size()];
+        event.name = name;
+        event.begin_ns = begin_ns;
+        event.duration_ns = end_ns >= begin_ns ? end_ns - begin_ns : 0;
+        ++buffer.written;
+    }
+
+    /**
+     * @brief Writes all recorded events as a Chrome trace JSON file
+     * @param filename Path of the output file
+     * @throw std::runtime_error if the file cannot be opened
+     */
+    void write(const std::string& filename) const {
+        std::ofstream file(filename);
+        if (!file.is_open()) {
+            throw std::runtime_error("Impossible to open the file " + filename);
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        uint64_t dropped = 0;
+        bool first = true;
+        auto separator = [&]() -> std::ofstream& {
+            if (!first) file << ",\n";
+            first = false;
+            return file;
+        };
+
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        separator() << R"({"name":"process_name","ph":"M","pid":1,"args":{"name":"MetalHeat3D"}})";
+        for (const auto& buffer : m_buffers) {
+            std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+            separator() << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << buffer->tid
+                        << R"(,"args":{"name":")" << (buffer->tid == 0 ? "solver" : "thread " + std::to_string(buffer->tid)) << "\"}}";
+
+            const size_t capacity = buffer->ring.size();
+            const uint64_t kept = std::min<uint64_t>(buffer->written, capacity);
+            dropped += buffer->written - kept;
+            for (uint64_t n = buffer->written - kept; n < buffer->written; ++n) {
+                const Event& event = buffer->ring[n % capacity];
+                separator() << R"({"name":")" << escape(m_names[event.name])
+                            << R"(","cat":"solver","ph":"X","pid":1,"tid":)" << buffer->tid
+                            << ",\"ts\":" << event.begin_ns / 1000 << '.' << pad3(event.begin_ns % 1000)
+                            << ",\"dur\":" << event.duration_ns / 1000 << '.' << pad3(event.duration_ns % 1000) << "}";
+            }
+        }
+        file << "\n],\"otherData\":{\"dropped_events\":" << dropped << "}}\n";
+    }
+
+private:
+    struct Event {
+        uint32_t name;          ///< Interned scope name
+        uint64_t begin_ns;      ///< Start on the trace clock
+        uint64_t duration_ns;   ///< Scope duration
+    };
+
+    struct ThreadBuffer {
+        uint32_t tid;               ///< Sequential thread number (0 = first thread to trace)
+        std::vector<Event> ring;    ///< Fixed-capacity event storage
+        uint64_t written = 0;       ///< Number of events ever written
+        mutable std::mutex mutex;   ///< Guards against a concurrent write()
+    };
+
+    TraceRecorder() : m_epoch(std::chrono::steady_clock::now()) {}
+
+    ThreadBuffer& thread_buffer() {
+        thread_local ThreadBuffer* local = nullptr;
+        if (!local) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto buffer = std::make_unique<ThreadBuffer>();
+            buffer->tid = static_cast<uint32_t>(m_buffers.size());
+            buffer->ring.resize(m_capacity);
+            local = buffer.get();
+            m_buffers.push_back(std::move(buffer));
+        }
+        return *local;
+    }
+
+    static std::string pad3(uint64_t value) {
+        std::string digits = std::to_string(value);
+        return std::string(3 - digits.size(), '0') + digits;
+    }
+
+    static std::string escape(const std::string& text) {
+        std::string escaped;
+        for (char c : text) {
+            if (c == '"' || c == '\\') escaped += '\\';
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    std::chrono::steady_clock::time_point m_epoch;              ///< Origin of the trace clock
+    std::atomic<bool> m_enabled{false};                         ///< Recording state
+    size_t m_capacity = 1 << 16;                                ///< Ring capacity for new threads
+    mutable std::mutex m_mutex;                                 ///< Guards names and buffer list
+    std::vector<std::string> m_names;                           ///< Interned scope names
+    std::unordered_map<std::string, uint32_t> m_ids;            ///< Name to identifier lookup
+    std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;       ///< One ring per traced thread
+};
+
+/**
+ * @class TraceScope
+ * @brief Records the lifetime of a block as one trace event
+ */
+class TraceScope {
+public:
+    explicit TraceScope(uint32_t name) : m_name(name), m_active(TraceRecorder::instance().enabled()) {
+        if (m_active) m_begin = TraceRecorder::instance().now_ns();
+    }
+
+    ~TraceScope() {
+        if (m_active) TraceRecorder::instance().record(m_name, m_begin, TraceRecorder::instance().now_ns());
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    uint32_t m_name;        ///< Interned scope name
+    bool m_active;          ///< Whether recording was enabled at construction
+    uint64_t m_begin = 0;   ///< Start on the trace clock
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+/**
+ * @brief Traces the enclosing block under the given name
+ *
+ * The name is interned once per call site, so a disabled scope does
+ * not allocate nor lock.
+ */
+#define TRACE_SCOPE(name) \
+    static const uint32_t TRACE_CONCAT(trace_id_, __LINE__) = TraceRecorder::instance().intern(name); \
+    TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(TRACE_CONCAT(trace_id_, __LINE__))
@@ -0,0 +1,74 @@
+/**
+ * @file frame_ring_reader.cpp
+ * @brief Follows the shared-memory frame ring of a running solver
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ *
+ * Reads every frame still in the ring as it is published and prints its
+ * iteration, time and value range. Frames overwritten before they could
+ * be read are counted as skipped. Stops when the solver closes the ring
+ * or after the requested number of frames.
+ *
+ * Usage:
+ *   frame_ring_reader <shared memory name> [frames]
+ */
+
+#include "frame_ring.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+int main(int argc, char** argv) {
+    if (argc != 2 && argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <shared memory name> [frames]" << std::endl;
+        return 2;
+    }
+    try {
+        const uint64_t limit = argc == 3 ? std::stoull(argv[2]) : 0;
+        const FrameRingReader ring(argv[1]);
+        const FrameRingHeader& info = ring.info();
+        std::cout << argv[1] << ": " << info.nx << "x" << info.ny << "x" << info.nz << ", "
+                  << info.slots << " slots" << std::endl;
+
+        std::vector<double> values;
+        FrameInfo frame;
+        uint64_t next = 0, read = 0, skipped = 0;
+        while (limit == 0 || read < limit) {
+            const bool closed = ring.closed();
+            const uint64_t published = ring.published();
+            if (next >= published) {
+                if (closed) break;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            // Les trames déjà sorties de l'anneau sont sautées
+            if (published - next > info.slots) {
+                skipped += published - info.slots - next;
+                next = published - info.slots;
+            }
+            if (!ring.read(next, values, frame)) {
+                ++skipped;
+                ++next;
+                continue;
+            }
+            const auto range = std::minmax_element(values.begin(), values.end());
+            double sum = 0.0;
+            for (double value : values) sum += value;
+            std::cout << "frame " << std::setw(6) << frame.frame
+                      << "  iteration " << std::setw(8) << frame.iteration
+                      << "  time " << std::scientific << std::setprecision(6) << frame.time
+                      << "  min " << *range.first << "  max " << *range.second
+                      << "  mean " << sum / values.size() << std::defaultfloat << std::endl;
+            ++read;
+            ++next;
+        }
+        std::cout << read << " frames read, " << skipped << " skipped" << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "frame_ring_reader: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
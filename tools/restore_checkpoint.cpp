@@ -0,0 +1,39 @@
+/**
+ * @file restore_checkpoint.cpp
+ * @brief Rebuilds the latest state of a chain of incremental checkpoints
+ * @author Etienne Rosin
+ * @date October 17, 2026
+ *
+ * The base and the following checkpoints of the latest chain are applied
+ * in order, and the result is written as a regular checkpoint that the
+ * solver resumes from with restart_file.
+ *
+ * Usage:
+ *   restore_checkpoint <parameters file> <incremental prefix> <output checkpoint>
+ */
+
+#include "parameters.hpp"
+#include "solution.hpp"
+#include "checkpoint.hpp"
+#include "incremental_checkpoint.hpp"
+
+#include <iostream>
+
+int main(int argc, char** argv) {
+    if (argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <parameters file> <incremental prefix> <output checkpoint>" << std::endl;
+        return 2;
+    }
+    try {
+        Parameters params(argv[1]);
+        Solution solution(params, "Restored state");
+        const IncrementalState state = IncrementalCheckpoint::restore(argv[2], params, solution);
+        Checkpoint::write(argv[3], solution, params, state.time, state.iteration);
+        std::cout << "Restored checkpoints " << state.base << " to " << state.sequence
+                  << " (iteration " << state.iteration << ", time " << state.time << ") into " << argv[3] << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "restore_checkpoint: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}